@@ -0,0 +1,154 @@
+// Copyright (c) 2013-2015 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: http://opensource.org/licenses/AFL-3.0
+
+#include "SSVUtils/Core/Core.hpp"
+#include "SSVUtils/Container/Container.hpp"
+#include "./utils/bench_utils.hpp"
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    using Rng = std::mt19937;
+
+    constexpr std::size_t lookupCount{10000};
+
+    template <typename TK>
+    TK genKey(std::size_t mI);
+
+    template <>
+    int genKey<int>(std::size_t mI)
+    {
+        return int(mI);
+    }
+
+    template <>
+    double genKey<double>(std::size_t mI)
+    {
+        return double(mI) * 0.5;
+    }
+
+    template <typename TK>
+    std::vector<std::pair<TK, int>> genItems(Rng& rng, std::size_t mCount)
+    {
+        std::vector<std::pair<TK, int>> result;
+        for(auto i(0u); i < mCount; ++i)
+            result.emplace_back(genKey<TK>(i * 2), int(i));
+
+        std::shuffle(std::begin(result), std::end(result), rng);
+        return result;
+    }
+
+    // Stored keys are even: half of the looked up keys are missing
+    template <typename TK>
+    std::vector<TK> genLookups(Rng& rng, std::size_t mCount)
+    {
+        std::uniform_int_distribution<std::size_t> dist(0, mCount * 2);
+
+        std::vector<TK> result;
+        for(auto i(0u); i < lookupCount; ++i)
+            result.emplace_back(genKey<TK>(dist(rng)));
+        return result;
+    }
+
+    template <typename TK>
+    void benchLookup(const std::string& name, Rng& rng, std::size_t mCount)
+    {
+        using namespace bench_impl;
+
+        ssvu::VecMap<TK, int> tm;
+        tm.insertBulk(genItems<TK>(rng, mCount));
+        auto lookups(genLookups<TK>(rng, mCount));
+
+        auto title(name + " " + std::to_string(mCount));
+        auto lookup([&]
+            {
+                std::size_t found{0};
+                for(const auto& k : lookups) found += tm.count(k);
+                do_not_optimize(found);
+            });
+
+        run_items(title + ": binary search", lookupCount, lookup);
+
+        tm.buildIndex();
+        run_items(title + ": Eytzinger index", lookupCount, lookup);
+    }
+
+    // Value as large as a `Json::Val`
+    struct BigValue
+    {
+        int x;
+        char padding[52];
+    };
+
+    template <typename TMap>
+    void benchLayout(const std::string& name, Rng& rng, std::size_t mCount)
+    {
+        using namespace bench_impl;
+
+        std::vector<std::pair<int, BigValue>> items;
+        for(const auto& i : genItems<int>(rng, mCount))
+            items.emplace_back(i.first, BigValue{i.second, {}});
+
+        TMap tm;
+        tm.insertBulk(std::move(items));
+        auto lookups(genLookups<int>(rng, mCount));
+
+        run_items(name + " " + std::to_string(mCount) + ": lookup",
+            lookupCount, [&]
+            {
+                std::size_t found{0};
+                for(const auto& k : lookups) found += tm.count(k);
+                do_not_optimize(found);
+            });
+    }
+
+    void benchInsert(Rng& rng, std::size_t mCount)
+    {
+        using namespace bench_impl;
+
+        auto items(genItems<int>(rng, mCount));
+        auto title("VecMap<int> " + std::to_string(mCount));
+
+        run_items(title + ": operator[]", mCount, [&]
+            {
+                ssvu::VecMap<int, int> tm;
+                for(const auto& i : items) tm[i.first] = i.second;
+                do_not_optimize(tm);
+            });
+
+        run_items(title + ": insertBulk", mCount, [&]
+            {
+                ssvu::VecMap<int, int> tm;
+                tm.insertBulk(items);
+                do_not_optimize(tm);
+            });
+    }
+}
+
+int main()
+{
+    Rng rng{1234};
+
+    bench_impl::section("Lookups (half missing)");
+    for(auto n : {1000u, 100000u, 1000000u})
+    {
+        benchLookup<int>("VecMap<int>", rng, n);
+        benchLookup<double>("VecMap<double>", rng, n);
+    }
+
+    bench_impl::section("Layouts (56-byte values, half missing)");
+    for(auto n : {1000u, 100000u, 1000000u})
+    {
+        benchLayout<ssvu::VecMap<int, BigValue>>("VecMap", rng, n);
+        benchLayout<ssvu::VecMapSoA<int, BigValue>>("VecMapSoA", rng, n);
+    }
+
+    bench_impl::section("Insertion (random order)");
+    for(auto n : {1000u, 20000u}) benchInsert(rng, n);
+}
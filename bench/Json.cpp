@@ -0,0 +1,256 @@
+// Copyright (c) 2013-2015 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: http://opensource.org/licenses/AFL-3.0
+
+#include "SSVUtils/Core/Core.hpp"
+#include "SSVUtils/Json/Json.hpp"
+#include "./utils/bench_utils.hpp"
+
+#include <algorithm>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct BenchEntity
+{
+    int id;
+    float x, y;
+    std::string name;
+    std::vector<int> tags;
+};
+
+SSVJ_CNV_OBJ_AUTO(BenchEntity, id, x, y, name, tags)
+
+namespace
+{
+    using Rng = std::mt19937;
+
+    std::string genWord(Rng& rng, bool unicode)
+    {
+        static const char* syllables[]{"ka", "lo", "mi", "ne", "su", "ta",
+            "ri", "vo", "\xc3\xa9t\xc3\xa9", "\xe6\x97\xa5\xe6\x9c\xac",
+            "\xd0\xbc\xd0\xb8\xd1\x80", "\xf0\x9f\x98\x80"};
+
+        std::uniform_int_distribution<int> count(1, 4);
+        std::uniform_int_distribution<int> pick(0, unicode ? 11 : 7);
+
+        std::string result;
+        for(auto i(count(rng)); i > 0; --i) result += syllables[pick(rng)];
+        return result;
+    }
+
+    // canada.json-like: a few features with very long coordinate lists
+    std::string genNumbers(Rng& rng)
+    {
+        std::uniform_real_distribution<double> lon(-141.0, -52.0);
+        std::uniform_real_distribution<double> lat(41.0, 83.0);
+
+        std::ostringstream o;
+        o.precision(15);
+        o << R"({"type": "FeatureCollection", "features": [)";
+        for(auto f(0); f < 8; ++f)
+        {
+            if(f != 0) o << ",";
+            o << R"({"type": "Feature", "properties": {"name": "Canada"}, )"
+              << R"("geometry": {"type": "Polygon", "coordinates": [[)";
+            for(auto i(0); i < 6000; ++i)
+                o << (i != 0 ? "," : "") << "[" << lon(rng) << ","
+                  << lat(rng) << "]";
+            o << "]]}}";
+        }
+        o << "]}";
+        return o.str();
+    }
+
+    std::string genTweet(Rng& rng, int id)
+    {
+        std::ostringstream o;
+        o << R"({"id": )" << id << R"(, "text": ")";
+        for(auto w(0); w < 16; ++w) o << genWord(rng, true) << " ";
+        o << R"(\n\"quoted\"", "user": {"name": ")" << genWord(rng, true)
+          << R"(", "screen_name": ")" << genWord(rng, false)
+          << R"(", "followers_count": )" << (id * 37 % 10007)
+          << R"(, "verified": )" << (id % 3 == 0 ? "true" : "false")
+          << R"(}, "lang": "ja", "in_reply_to": null, "hashtags": [")"
+          << genWord(rng, true) << R"(", ")" << genWord(rng, true)
+          << R"("]})";
+        return o.str();
+    }
+
+    // twitter.json-like: many small objects dominated by (UTF-8) strings
+    std::string genStrings(Rng& rng)
+    {
+        std::string result{R"({"statuses": [)"};
+        for(auto i(0); i < 4000; ++i)
+        {
+            if(i != 0) result += ",";
+            result += genTweet(rng, i);
+        }
+        return result + "]}";
+    }
+
+    // Many deeply nested arrays/objects
+    std::string genNested()
+    {
+        std::string one;
+        for(auto d(0); d < 256; ++d) one += d % 2 == 0 ? R"({"n": [)" : "[";
+        one += "0";
+        for(auto d(255); d >= 0; --d) one += d % 2 == 0 ? "]}" : "]";
+
+        std::string result{"["};
+        for(auto i(0); i < 64; ++i) result += (i != 0 ? "," : "") + one;
+        return result + "]";
+    }
+
+    // Single object with many keys, inserted in random order
+    std::string genWide(Rng& rng)
+    {
+        std::vector<int> keys(20000);
+        for(auto i(0u); i < keys.size(); ++i) keys[i] = i;
+        std::shuffle(std::begin(keys), std::end(keys), rng);
+
+        std::string result{"{"};
+        for(auto i(0u); i < keys.size(); ++i)
+            result += (i != 0 ? ",\"key" : "\"key") +
+                      std::to_string(keys[i]) + "\": " + std::to_string(i);
+        return result + "}";
+    }
+
+    // Newline-delimited documents
+    std::vector<std::string> genNdjson(Rng& rng)
+    {
+        std::vector<std::string> result;
+        for(auto i(0); i < 4000; ++i) result.emplace_back(genTweet(rng, i));
+        return result;
+    }
+
+    void benchDocument(const std::string& name, const std::string& src)
+    {
+        using namespace bench_impl;
+
+        section(name + " (" + std::to_string(src.size() / 1024) + " KB)");
+
+        run(name + ": Reader", src.size(), [&]
+            {
+                auto v(ssvj::fromStr(src));
+                do_not_optimize(v);
+            });
+
+        auto v(ssvj::fromStr(src));
+        auto minified(v.getWriteToStr<ssvj::WSMinified>());
+        auto pretty(v.getWriteToStr<ssvj::WSPretty>());
+
+        run(name + ": Writer<WSMinified>", minified.size(), [&]
+            {
+                auto s(v.getWriteToStr<ssvj::WSMinified>());
+                do_not_optimize(s);
+            });
+
+        run(name + ": Writer<WSPretty>", pretty.size(), [&]
+            {
+                auto s(v.getWriteToStr<ssvj::WSPretty>());
+                do_not_optimize(s);
+            });
+
+        run(name + ": Val copy", src.size(), [&]
+            {
+                auto copy(v);
+                do_not_optimize(copy);
+            });
+    }
+
+    void benchNdjson(const std::vector<std::string>& docs)
+    {
+        using namespace bench_impl;
+
+        std::size_t bytes{0};
+        for(const auto& d : docs) bytes += d.size() + 1;
+
+        section("ndjson (" + std::to_string(docs.size()) + " documents)");
+
+        auto r(run("ndjson: Reader (all lines)", bytes, [&]
+            {
+                for(const auto& d : docs)
+                {
+                    auto v(ssvj::fromStr(d));
+                    do_not_optimize(v);
+                }
+            }));
+
+        std::printf("%-44s %12.1f allocs/document\n", "ndjson: Reader",
+            r.allocs_per_op / docs.size());
+    }
+
+    void benchCnv(Rng& rng)
+    {
+        using namespace bench_impl;
+
+        std::vector<BenchEntity> entities(10000);
+        for(auto i(0u); i < entities.size(); ++i)
+        {
+            auto& e(entities[i]);
+            e.id = i;
+            e.x = float(i) * 0.5f;
+            e.y = float(i) * 2.5f;
+            e.name = genWord(rng, false);
+            e.tags = {int(i % 7), int(i % 13), int(i % 17)};
+        }
+
+        auto bytes(ssvj::getArch(entities)
+                       .getWriteToStr<ssvj::WSMinified>()
+                       .size());
+
+        section("Cnv (" + std::to_string(entities.size()) + " entities)");
+
+        run("Cnv: arch (C++ -> Val)", bytes, [&]
+            {
+                auto v(ssvj::getArch(entities));
+                do_not_optimize(v);
+            });
+
+        auto v(ssvj::getArch(entities));
+        run("Cnv: extr (Val -> C++)", bytes, [&]
+            {
+                auto out(ssvj::getExtr<std::vector<BenchEntity>>(v));
+                do_not_optimize(out);
+            });
+
+        run("Cnv: round trip through minified text", bytes, [&]
+            {
+                auto str(ssvj::getArch(entities)
+                             .getWriteToStr<ssvj::WSMinified>());
+                auto out(ssvj::getExtr<std::vector<BenchEntity>>(
+                    ssvj::fromStr(str)));
+                do_not_optimize(out);
+            });
+
+        auto bin(ssvj::getArchBin(entities));
+        std::printf("%-44s %12zu bytes (text: %zu)\n", "Bin: snapshot size",
+            bin.size(), bytes);
+
+        run("Bin: archBin (C++ -> binary)", bin.size(), [&]
+            {
+                ssvj::archBin(bin, entities);
+                do_not_optimize(bin);
+            });
+
+        run("Bin: extrBin (binary -> C++)", bin.size(), [&]
+            {
+                auto out(ssvj::getExtrBin<std::vector<BenchEntity>>(bin));
+                do_not_optimize(out);
+            });
+    }
+}
+
+int main()
+{
+    Rng rng{1234};
+
+    benchDocument("numbers", genNumbers(rng));
+    benchDocument("strings", genStrings(rng));
+    benchDocument("nested", genNested());
+    benchDocument("wide", genWide(rng));
+    benchNdjson(genNdjson(rng));
+    benchCnv(rng);
+}
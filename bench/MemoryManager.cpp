@@ -0,0 +1,410 @@
+// Copyright (c) 2013-2015 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: http://opensource.org/licenses/AFL-3.0
+
+#include "SSVUtils/Core/Core.hpp"
+#include "SSVUtils/MemoryManager/MemoryManager.hpp"
+#include "./utils/bench_utils.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+// Single object type, used by the mono containers
+struct Particle
+{
+    float x, y, vx, vy;
+    int life;
+
+    // Only used by the `std::vector` baseline, which has no alive flags
+    bool dead{false};
+
+    inline Particle(float mX, float mY) noexcept
+        : x{mX}, y{mY}, vx{1.f}, vy{-1.f}, life{100}
+    {
+    }
+
+    inline float update() noexcept
+    {
+        x += vx;
+        y += vy;
+        --life;
+        return x + y;
+    }
+};
+
+// Object hierarchy with differently sized types, used by the poly containers
+struct Shape
+{
+    float x{0}, y{0};
+    bool dead{false};
+
+    inline virtual ~Shape()
+    {
+    }
+    virtual float update() noexcept = 0;
+};
+
+struct Circle : Shape
+{
+    float radius{1.f};
+
+    inline float update() noexcept override
+    {
+        x += radius;
+        return x;
+    }
+};
+
+struct Rect : Shape
+{
+    float w{1.f}, h{2.f}, angle{0.f};
+
+    inline float update() noexcept override
+    {
+        angle += 0.1f;
+        return w * h + angle;
+    }
+};
+
+struct Polygon : Shape
+{
+    float points[16]{};
+
+    inline float update() noexcept override
+    {
+        float result{0};
+        for(auto& p : points) result += p += 1.f;
+        return result;
+    }
+};
+
+namespace
+{
+    using Rng = std::mt19937;
+
+    // Baseline: every object is allocated with `std::make_unique`, dead
+    // objects are flagged and erased on refresh
+    template <typename TBase>
+    struct StdVector
+    {
+        std::vector<std::unique_ptr<TBase>> items;
+
+        template <typename T = TBase, typename... TArgs>
+        inline void create(TArgs&&... mArgs)
+        {
+            items.emplace_back(std::make_unique<T>(FWD(mArgs)...));
+        }
+
+        inline void del(TBase& mX) noexcept
+        {
+            mX.dead = true;
+        }
+
+        inline void refresh()
+        {
+            items.erase(std::remove_if(std::begin(items), std::end(items),
+                            [](const auto& mP)
+                            {
+                                return mP->dead;
+                            }),
+                std::end(items));
+        }
+
+        template <typename TF>
+        inline void forEach(const TF& mFn)
+        {
+            for(auto& p : items) mFn(*p);
+        }
+
+        inline void clear() noexcept
+        {
+            items.clear();
+        }
+    };
+
+    // `MonoManager`, `PolyManager`, `PolyFixedManager`
+    template <typename TManager>
+    struct Manager
+    {
+        TManager items;
+
+        template <typename T, typename... TArgs>
+        inline void create(TArgs&&... mArgs)
+        {
+            items.template create<T>(FWD(mArgs)...);
+        }
+
+        template <typename TBase>
+        inline void del(TBase& mX) noexcept
+        {
+            items.del(mX);
+        }
+
+        inline void refresh()
+        {
+            items.refresh();
+        }
+
+        template <typename TF>
+        inline void forEach(const TF& mFn)
+        {
+            for(auto& p : items) mFn(*p);
+        }
+
+        inline void clear() noexcept
+        {
+            items.clear();
+        }
+    };
+
+    // `MonoRecVector`, `PolyRecVector`: no deletion of single objects, so
+    // only churn (through `clear`) and iteration are measured
+    template <typename TRecVector>
+    struct RecVector
+    {
+        TRecVector items;
+
+        template <typename T, typename... TArgs>
+        inline void create(TArgs&&... mArgs)
+        {
+            items.template create<T>(FWD(mArgs)...);
+        }
+
+        // Objects are added immediately
+        inline void refresh() noexcept
+        {
+        }
+
+        template <typename TF>
+        inline void forEach(const TF& mFn)
+        {
+            for(auto& p : items) mFn(*p);
+        }
+
+        inline void clear() noexcept
+        {
+            items.clear();
+        }
+    };
+
+    constexpr std::size_t count{10000};
+
+    // Creates the `i`-th object of a mono or poly population
+    template <typename TBase>
+    struct Populate;
+
+    template <>
+    struct Populate<Particle>
+    {
+        template <typename TC>
+        inline static void create(TC& mC, std::size_t mI)
+        {
+            mC.template create<Particle>(float(mI), float(mI));
+        }
+    };
+
+    // Circles, rects and polygons in a 3:2:1 ratio, interleaved
+    template <>
+    struct Populate<Shape>
+    {
+        template <typename TC>
+        inline static void create(TC& mC, std::size_t mI)
+        {
+            switch(mI % 6)
+            {
+                case 0:
+                case 2:
+                case 4: mC.template create<Circle>(); break;
+                case 1:
+                case 3: mC.template create<Rect>(); break;
+                default: mC.template create<Polygon>(); break;
+            }
+        }
+    };
+
+    // Managers add the created objects on the next refresh
+    template <typename TBase, typename TC>
+    void populate(TC& mC, std::size_t mCount)
+    {
+        for(auto i(0u); i < mCount; ++i) Populate<TBase>::create(mC, i);
+        mC.refresh();
+    }
+
+    template <typename TBase, typename TC>
+    void benchChurn(const std::string& name, TC& mC)
+    {
+        bench_impl::run_items(name + ": create/destroy churn", count, [&]
+            {
+                populate<TBase>(mC, count);
+                mC.clear();
+            });
+    }
+
+    template <typename TBase, typename TC>
+    void benchIteration(const std::string& name, TC& mC)
+    {
+        populate<TBase>(mC, count);
+
+        bench_impl::run_items(name + ": iteration", count, [&]
+            {
+                float sum{0};
+                mC.forEach([&sum](auto& mX)
+                    {
+                        sum += mX.update();
+                    });
+                bench_impl::do_not_optimize(sum);
+            });
+
+        mC.clear();
+    }
+
+    // Kills `mDeadRatio` of the objects, refreshes, and recreates the
+    // killed objects to restore the initial population
+    template <typename TBase, typename TC>
+    void benchRefresh(const std::string& name, TC& mC, double mDeadRatio)
+    {
+        Rng rng{1234};
+        std::bernoulli_distribution dist{mDeadRatio};
+        std::vector<char> dead(count);
+        for(auto& d : dead) d = dist(rng);
+
+        auto deadCount(std::count(std::begin(dead), std::end(dead), 1));
+
+        auto title(name + ": refresh " +
+                   std::to_string(std::lround(mDeadRatio * 100)) +
+                   "% dead (+refill)");
+
+        populate<TBase>(mC, count);
+
+        bench_impl::run_items(title, count, [&]
+            {
+                std::size_t i{0};
+                mC.forEach([&](auto& mX)
+                    {
+                        if(dead[i++]) mC.del(mX);
+                    });
+
+                mC.refresh();
+                populate<TBase>(mC, deadCount);
+            });
+
+        mC.clear();
+    }
+
+    template <typename TBase, typename TC>
+    void benchAll(const std::string& name, TC& mC)
+    {
+        benchChurn<TBase>(name, mC);
+        benchIteration<TBase>(name, mC);
+        for(auto r : {0.01, 0.5, 0.99}) benchRefresh<TBase>(name, mC, r);
+    }
+
+    template <typename TBase, typename TC>
+    void benchNoRefresh(const std::string& name, TC& mC)
+    {
+        benchChurn<TBase>(name, mC);
+        benchIteration<TBase>(name, mC);
+    }
+
+    // Resident memory of a population of one million objects
+    template <typename TBase, typename TC>
+    void benchMemory(const std::string& name)
+    {
+        constexpr std::size_t bigCount{1000000};
+
+        bench_impl::release_free_memory();
+        auto before(bench_impl::get_rss_bytes());
+        {
+            TC c;
+            populate<TBase>(c, bigCount);
+
+            auto after(bench_impl::get_rss_bytes());
+            std::printf("%-44s %10.2f bytes/item\n",
+                (name + ": resident memory").c_str(),
+                after > before ? double(after - before) / bigCount : 0.0);
+        }
+        bench_impl::release_free_memory();
+    }
+
+    void printPeakRss()
+    {
+        std::printf("%-44s %10.2f MB\n", "Peak RSS",
+            bench_impl::get_peak_rss_bytes() / (1024.0 * 1024.0));
+    }
+
+    void benchMono()
+    {
+        using namespace bench_impl;
+        section("Mono (" + std::to_string(count) + " Particle)");
+
+        {
+            StdVector<Particle> c;
+            benchAll<Particle>("unique_ptr", c);
+        }
+        {
+            Manager<ssvu::MonoManager<Particle>> c;
+            benchAll<Particle>("MonoManager", c);
+        }
+        {
+            RecVector<ssvu::MonoRecVector<Particle>> c;
+            benchNoRefresh<Particle>("MonoRecVector", c);
+        }
+    }
+
+    void benchPoly()
+    {
+        using namespace bench_impl;
+        section("Poly (" + std::to_string(count) +
+                " Circle/Rect/Polygon, 3:2:1)");
+
+        {
+            StdVector<Shape> c;
+            benchAll<Shape>("unique_ptr", c);
+        }
+        {
+            Manager<ssvu::PolyManager<Shape>> c;
+            benchAll<Shape>("PolyManager", c);
+        }
+        {
+            Manager<ssvu::PolyFixedManager<Shape, Circle, Rect, Polygon>> c;
+            benchAll<Shape>("PolyFixedManager", c);
+        }
+        {
+            RecVector<ssvu::PolyRecVector<Shape>> c;
+            benchNoRefresh<Shape>("PolyRecVector", c);
+        }
+    }
+
+    void benchMemoryAll()
+    {
+        bench_impl::section("Memory (1000000 objects)");
+
+        benchMemory<Particle, StdVector<Particle>>("Mono unique_ptr");
+        benchMemory<Particle, Manager<ssvu::MonoManager<Particle>>>(
+            "MonoManager");
+        benchMemory<Particle, RecVector<ssvu::MonoRecVector<Particle>>>(
+            "MonoRecVector");
+        benchMemory<Shape, StdVector<Shape>>("Poly unique_ptr");
+        benchMemory<Shape, Manager<ssvu::PolyManager<Shape>>>("PolyManager");
+        benchMemory<Shape,
+            Manager<ssvu::PolyFixedManager<Shape, Circle, Rect, Polygon>>>(
+            "PolyFixedManager");
+        benchMemory<Shape, RecVector<ssvu::PolyRecVector<Shape>>>(
+            "PolyRecVector");
+
+        printPeakRss();
+    }
+}
+
+int main()
+{
+    // Measured first, while the allocator holds as little memory as possible
+    benchMemoryAll();
+
+    benchMono();
+    benchPoly();
+}
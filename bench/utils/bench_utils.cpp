@@ -0,0 +1,92 @@
+// Replacements of the global allocation functions, counting allocations.
+// Defined out of line, so that the compiler does not pair the `malloc` and
+// `free` calls inside them with the `new` and `delete` expressions of the
+// benchmarks (`-Wmismatched-new-delete`).
+
+#include "./bench_utils.hpp"
+
+#include <cstdlib>
+#include <new>
+
+#if defined(_MSC_VER)
+#include <malloc.h>
+#endif
+
+void* operator new(std::size_t size)
+{
+    ++bench_impl::get_alloc_count();
+    if(auto p = std::malloc(size == 0 ? 1 : size)) return p;
+    throw std::bad_alloc{};
+}
+
+void* operator new[](std::size_t size)
+{
+    return ::operator new(size);
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+// Over-aligned types (e.g. the aligned storage of managers and growable
+// arrays) are allocated through the `std::align_val_t` overloads
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    ++bench_impl::get_alloc_count();
+
+    auto a(static_cast<std::size_t>(alignment));
+#if defined(_MSC_VER)
+    if(auto p = _aligned_malloc(size == 0 ? 1 : size, a)) return p;
+#else
+    // `std::aligned_alloc` requires a multiple of the alignment
+    auto rounded((size + a - 1) / a * a);
+    if(auto p = std::aligned_alloc(a, rounded == 0 ? a : rounded)) return p;
+#endif
+    throw std::bad_alloc{};
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return ::operator new(size, alignment);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept
+{
+#if defined(_MSC_VER)
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+void operator delete[](void* p, std::align_val_t alignment) noexcept
+{
+    ::operator delete(p, alignment);
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t alignment) noexcept
+{
+    ::operator delete(p, alignment);
+}
+
+void operator delete[](
+    void* p, std::size_t, std::align_val_t alignment) noexcept
+{
+    ::operator delete(p, alignment);
+}
@@ -0,0 +1,184 @@
+#pragma once
+
+// Shared helpers for the benchmark executables.
+// Allocations are counted by the global allocation functions defined in
+// `bench_utils.cpp`, which is linked into every benchmark executable.
+
+#include "SSVUtils/Core/Core.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+namespace bench_impl
+{
+    inline auto& get_alloc_count() noexcept
+    {
+        static std::atomic<std::size_t> count{0};
+        return count;
+    }
+
+    /// @brief Prevents the optimizer from discarding `x`.
+    template <typename T>
+    inline void do_not_optimize(const T& x) noexcept
+    {
+        asm volatile("" : : "g"(&x) : "memory");
+    }
+
+    /// @brief Result of a single benchmark run.
+    struct result
+    {
+        double ns_per_op;
+        double mb_per_s;
+        double allocs_per_op;
+        std::size_t ops;
+    };
+
+    inline double get_min_seconds() noexcept
+    {
+        static double min_seconds{[]
+            {
+                auto env(std::getenv("SSVU_BENCH_MIN_SECONDS"));
+                return env != nullptr ? std::atof(env) : 0.25;
+            }()};
+
+        return min_seconds;
+    }
+
+    /// @brief Raw measurement of a benchmark: total time, number of calls
+    /// and number of allocations.
+    struct measurement
+    {
+        double seconds;
+        std::size_t ops;
+        std::size_t allocs;
+    };
+
+    /// @brief Runs `f` repeatedly for at least `get_min_seconds()`, after a
+    /// warm-up call.
+    template <typename TF>
+    inline measurement measure(TF&& f)
+    {
+        // Warm-up
+        f();
+
+        std::size_t ops{0};
+        auto allocs_before(get_alloc_count().load());
+
+        using clock = std::chrono::high_resolution_clock;
+        auto start(clock::now());
+        double seconds{0};
+        do
+        {
+            f();
+            ++ops;
+
+            seconds =
+                std::chrono::duration<double>(clock::now() - start).count();
+        } while(seconds < get_min_seconds());
+
+        return {seconds, ops, get_alloc_count().load() - allocs_before};
+    }
+
+    /// @brief Runs `f` repeatedly for at least `get_min_seconds()` and
+    /// prints time per operation, throughput for `bytes_per_op` and
+    /// allocations per operation.
+    template <typename TF>
+    inline result run(
+        const std::string& title, std::size_t bytes_per_op, TF&& f)
+    {
+        auto m(measure(f));
+
+        result r;
+        r.ops = m.ops;
+        r.ns_per_op = m.seconds * 1e9 / m.ops;
+        r.mb_per_s = bytes_per_op == 0
+                         ? 0.0
+                         : (double(bytes_per_op) * m.ops) /
+                               (1024.0 * 1024.0) / m.seconds;
+        r.allocs_per_op = double(m.allocs) / m.ops;
+
+        std::printf("%-44s %12.0f ns/op %10.2f MB/s %12.1f allocs/op\n",
+            title.c_str(), r.ns_per_op, r.mb_per_s, r.allocs_per_op);
+        std::fflush(stdout);
+
+        return r;
+    }
+
+    /// @brief Runs `f`, which processes `items_per_op` items, repeatedly
+    /// for at least `get_min_seconds()` and prints time, throughput and
+    /// allocations per item.
+    template <typename TF>
+    inline void run_items(
+        const std::string& title, std::size_t items_per_op, TF&& f)
+    {
+        auto m(measure(f));
+        auto items(double(items_per_op) * m.ops);
+
+        std::printf("%-44s %10.2f ns/item %8.2f M/s %10.3f allocs/item\n",
+            title.c_str(), m.seconds * 1e9 / items,
+            items / 1e6 / m.seconds, double(m.allocs) / items);
+        std::fflush(stdout);
+    }
+
+    /// @brief Returns the resident set size of the process, in bytes, or 0
+    /// if unknown.
+    inline std::size_t get_rss_bytes() noexcept
+    {
+#if defined(__linux__)
+        std::size_t pages{0}, resident{0};
+        if(auto f = std::fopen("/proc/self/statm", "r"))
+        {
+            if(std::fscanf(f, "%zu %zu", &pages, &resident) != 2)
+                resident = 0;
+            std::fclose(f);
+        }
+        return resident * std::size_t(sysconf(_SC_PAGESIZE));
+#else
+        return 0;
+#endif
+    }
+
+    /// @brief Returns the peak resident set size of the process, in bytes,
+    /// or 0 if unknown.
+    inline std::size_t get_peak_rss_bytes() noexcept
+    {
+#if defined(__linux__) || defined(__APPLE__)
+        rusage usage;
+        if(getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#if defined(__APPLE__)
+        return std::size_t(usage.ru_maxrss);
+#else
+        return std::size_t(usage.ru_maxrss) * 1024;
+#endif
+#else
+        return 0;
+#endif
+    }
+
+    /// @brief Returns the free memory of the allocator to the system, where
+    /// supported, so that `get_rss_bytes()` deltas are meaningful.
+    inline void release_free_memory() noexcept
+    {
+#if defined(__GLIBC__)
+        malloc_trim(0);
+#endif
+    }
+
+    inline void section(const std::string& title)
+    {
+        std::printf("\n== %s\n", title.c_str());
+    }
+}
@@ -6,8 +6,10 @@
 #define SSVU_CONTAINER
 
 
+#include "SSVUtils/Container/Inc/EytzingerIndex.hpp"
 #include "SSVUtils/Container/Inc/VecMapBase.hpp"
 #include "SSVUtils/Container/Inc/VecSorted.hpp"
 #include "SSVUtils/Container/Inc/VecMap.hpp"
+#include "SSVUtils/Container/Inc/VecMapSoA.hpp"
 
 #endif
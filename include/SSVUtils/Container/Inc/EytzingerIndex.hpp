@@ -0,0 +1,164 @@
+// Copyright (c) 2013-2015 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: http://opensource.org/licenses/AFL-3.0
+
+#ifndef SSVU_IMPL_CONTAINER_EYTZINGERINDEX
+#define SSVU_IMPL_CONTAINER_EYTZINGERINDEX
+
+#include "SSVUtils/Core/Assert/Assert.hpp"
+#include "SSVUtils/Core/Detection/Detection.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace ssvu
+{
+namespace Impl
+{
+/// @brief Read-optimized search index over the keys of a sorted vector.
+/// @details Keys are copied in Eytzinger (breadth-first) order: the
+/// children of the key at position `k` are at `2k` and `2k + 1`, so the
+/// first levels of every search share the same few cache lines, and the
+/// next levels can be prefetched. Each key is stored with its position in
+/// the sorted vector. The index does not track the vector: it must be
+/// rebuilt after the vector is modified. Only supports trivially copyable
+/// keys.
+template <typename TK>
+class EytzingerIndex
+{
+private:
+    // The 16 descendants of the key at `k` four levels down are consecutive,
+    // starting at `16k`: they are prefetched while the search descends
+    static constexpr std::size_t prefetchKeys{16};
+
+    struct Storage
+    {
+        // 1-based: position 0 is unused
+        std::vector<TK> keys;
+        std::vector<std::size_t> ranks;
+    };
+
+    // Allocated only when built, so that unused indices stay small
+    std::unique_ptr<Storage> storage;
+
+    template <typename TGetKey>
+    inline void fill(
+        std::size_t mK, std::size_t& mRank, const TGetKey& mGetKey)
+    {
+        if(mK >= storage->keys.size()) return;
+
+        fill(2 * mK, mRank, mGetKey);
+        storage->keys[mK] = mGetKey(mRank);
+        storage->ranks[mK] = mRank++;
+        fill(2 * mK + 1, mRank, mGetKey);
+    }
+
+    inline static std::size_t getTrailingOnes(std::size_t mX) noexcept
+    {
+#if(defined(SSVU_COMPILER_CLANG) || defined(SSVU_COMPILER_GCC))
+        return __builtin_ctzll(~static_cast<unsigned long long>(mX));
+#else
+        std::size_t result{0};
+        for(; (mX & 1) != 0; mX >>= 1) ++result;
+        return result;
+#endif
+    }
+
+    inline static void prefetch(
+        const std::vector<TK>& mKeys, std::size_t mK) noexcept
+    {
+#if(defined(SSVU_COMPILER_CLANG) || defined(SSVU_COMPILER_GCC))
+        // Small indices stay in the cache anyway
+        if(mKeys.size() <= prefetchKeys) return;
+
+        auto first(std::min(mK * prefetchKeys, mKeys.size() - prefetchKeys));
+        auto p(reinterpret_cast<const char*>(mKeys.data() + first));
+        for(std::size_t o{0}; o < prefetchKeys * sizeof(TK); o += 64)
+            __builtin_prefetch(p + o);
+#else
+        (void)mKeys;
+        (void)mK;
+#endif
+    }
+
+public:
+    /// @brief Whether the index can be built for `TK`. Comparisons of other
+    /// keys, e.g. strings, dereference memory outside of the index, and are
+    /// not faster than a binary search.
+    static constexpr bool supported{std::is_trivially_copyable<TK>{}};
+
+    inline EytzingerIndex() = default;
+    inline EytzingerIndex(const EytzingerIndex& mX)
+        : storage{mX.storage != nullptr
+                      ? std::make_unique<Storage>(*mX.storage)
+                      : nullptr}
+    {
+    }
+    inline EytzingerIndex(EytzingerIndex&&) noexcept = default;
+
+    inline auto& operator=(const EytzingerIndex& mX)
+    {
+        storage = mX.storage != nullptr ? std::make_unique<Storage>(*mX.storage)
+                                        : nullptr;
+        return *this;
+    }
+    inline EytzingerIndex& operator=(EytzingerIndex&&) noexcept = default;
+
+    /// @brief Builds the index over `mCount` sorted keys. `mGetKey(i)` must
+    /// return the `i`-th key.
+    template <typename TGetKey>
+    inline void build(std::size_t mCount, const TGetKey& mGetKey)
+    {
+        SSVU_ASSERT_STATIC(
+            supported, "The lookup index requires trivially copyable keys");
+
+        if(storage == nullptr) storage = std::make_unique<Storage>();
+
+        storage->keys.resize(mCount + 1);
+        storage->ranks.resize(mCount + 1);
+
+        std::size_t rank{0};
+        fill(1, rank, mGetKey);
+    }
+
+    inline void clear() noexcept
+    {
+        storage.reset();
+    }
+
+    inline bool isBuilt() const noexcept
+    {
+        return storage != nullptr;
+    }
+
+    /// @brief Returns the position in the sorted vector of the first key
+    /// not less than `mKey`, or the number of keys if there is none.
+    template <typename TKey, typename TLess>
+    inline std::size_t lowerBound(
+        const TKey& mKey, const TLess& mLess) const noexcept
+    {
+        SSVU_ASSERT(isBuilt());
+
+        const auto& keys(storage->keys);
+        auto count(keys.size() - 1);
+        std::size_t k{1};
+
+        // Branchless descent: go right while the key is less than `mKey`
+        while(k <= count)
+        {
+            prefetch(keys, k);
+            k = 2 * k + std::size_t(mLess(keys[k], mKey));
+        }
+
+        // Undo the right turns taken after the last left turn
+        k >>= getTrailingOnes(k) + 1;
+        return k == 0 ? count : storage->ranks[k];
+    }
+};
+} // namespace Impl
+} // namespace ssvu
+
+#endif
@@ -5,9 +5,12 @@
 #ifndef SSVU_IMPL_CONTAINER_VECMAP
 #define SSVU_IMPL_CONTAINER_VECMAP
 
+#include "SSVUtils/Container/Inc/EytzingerIndex.hpp"
 #include "SSVUtils/Container/Inc/VecMapBase.hpp"
 #include "SSVUtils/Container/Inc/VecSorted.hpp"
+#include "SSVUtils/Container/Inc/VecMapSoA.hpp"
 
+#include <type_traits>
 #include <vector>
 #include <utility>
 
@@ -15,12 +18,16 @@ namespace ssvu
 {
 /// @brief Map-like sorted container implemented on top of an `std::vector`.
 /// @details Key/value pairs are stored in a sorted vector of `std::pair<TK,
-/// TV>`.
+/// TV>`. See `VecMapSoA` for a layout with separate key and value vectors.
 /// @tparam TK Key type.
 /// @tparam TV Value type.
-template <typename TK, typename TV>
-class VecMap : public Impl::VecMapBase<VecMap<TK, TV>>
+/// @tparam TLayout Layout policy: `VecMapLayoutAoS` or `VecMapLayoutSoA`.
+template <typename TK, typename TV, typename TLayout>
+class VecMap : public Impl::VecMapBase<VecMap<TK, TV, TLayout>>
 {
+    SSVU_ASSERT_STATIC(std::is_same<TLayout, VecMapLayoutAoS>{},
+        "Unknown VecMap layout policy");
+
     template <typename>
     friend class Impl::VecMapBase;
 
@@ -30,11 +37,22 @@ public:
 
 private:
     std::vector<Item> data;
+    Impl::EytzingerIndex<TK> index;
+
+    inline static const auto& getKey(const Item& mX) noexcept
+    {
+        return mX.first;
+    }
 
     // Map-like lookup based on keys
     template <typename T>
     inline static auto lookupHelper(T& mVecMap, const TK& mKey) noexcept
     {
+        if(mVecMap.index.isBuilt())
+            return std::begin(mVecMap.data) +
+                   mVecMap.index.lowerBound(mKey,
+                       [](const TK& mA, const TK& mB) { return mA < mB; });
+
         return lowerBound(mVecMap.data, mKey,
             [](const auto& mA, const auto& mB) { return mA.first < mB; });
     }
@@ -48,6 +66,12 @@ private:
         return lookupHelper(*this, mKey);
     }
 
+    // Ordering of the stored items, used by bulk insertions
+    inline static bool itemLess(const Item& mA, const Item& mB) noexcept
+    {
+        return mA.first < mB.first;
+    }
+
     // Returns validity of a looked-up object
     template <typename T>
     inline bool is(const T& mItr, const TK& mKey) const noexcept
@@ -57,10 +81,11 @@ private:
 
 public:
     inline VecMap() = default;
-    inline VecMap(const VecMap& mVM) : data{mVM.data}
+    inline VecMap(const VecMap& mVM) : data{mVM.data}, index{mVM.index}
     {
     }
-    inline VecMap(VecMap&& mVM) noexcept : data{std::move(mVM.data)}
+    inline VecMap(VecMap&& mVM) noexcept
+        : data{std::move(mVM.data)}, index{std::move(mVM.index)}
     {
     }
     inline VecMap(std::initializer_list<Item>&& mIL) : data{std::move(mIL)}
@@ -72,11 +97,13 @@ public:
     inline auto& operator=(const VecMap& mVM)
     {
         data = mVM.data;
+        index = mVM.index;
         return *this;
     }
     inline auto& operator=(VecMap&& mVM) noexcept
     {
         data = std::move(mVM.data);
+        index = std::move(mVM.index);
         return *this;
     }
 
@@ -86,13 +113,16 @@ public:
     }
 
     /// @brief Returns a non-const reference to the value with key `mKey`.
-    /// The key/value pair is created if unexistant.
+    /// The key/value pair is created if unexistant, dropping the lookup
+    /// index.
     template <typename TTK>
     inline auto& operator[](TTK&& mKey)
     {
         auto itr(lookup(mKey));
-        return is(itr, mKey) ? itr->second
-                             : data.emplace(itr, FWD(mKey), TV{})->second;
+        if(is(itr, mKey)) return itr->second;
+
+        index.clear();
+        return data.emplace(itr, FWD(mKey), TV{})->second;
     }
 
     /// @brief Returns a const reference to the value with key `mKey`. An
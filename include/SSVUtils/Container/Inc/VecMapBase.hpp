@@ -5,12 +5,111 @@
 #ifndef SSVU_IMPL_CONTAINER_VECMAPBASE
 #define SSVU_IMPL_CONTAINER_VECMAPBASE
 
+#include "SSVUtils/Core/Common/Aliases.hpp"
 #include "SSVUtils/Core/Common/Casts.hpp"
 
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
 namespace ssvu
 {
+/// @brief Policy used by bulk insertions to resolve items with equivalent
+/// keys.
+enum class VecDupPolicy
+{
+    KeepLast,  ///< The last inserted item replaces the others.
+    KeepFirst  ///< Items equivalent to an existing item are discarded.
+};
+
+/// @brief `VecMap` layout policy: keys and values are stored together, in
+/// a vector of `std::pair<TK, TV>`.
+struct VecMapLayoutAoS
+{
+};
+
+/// @brief `VecMap` layout policy: keys and values are stored in parallel
+/// vectors.
+struct VecMapLayoutSoA
+{
+};
+
+template <typename TK, typename TV, typename TLayout = VecMapLayoutAoS>
+class VecMap;
+
 namespace Impl
 {
+/// @brief Stable-sorts [`mBegin`, `mEnd`) and keeps one item out of every
+/// run of equivalent items, according to `mPolicy`. Returns the new end of
+/// the range.
+template <typename TItr, typename TLess>
+inline TItr sortUnique(
+    TItr mBegin, TItr mEnd, const TLess& mLess, VecDupPolicy mPolicy)
+{
+    // Stable, so that equivalent items keep their insertion order
+    std::stable_sort(mBegin, mEnd, mLess);
+
+    auto unique(mBegin);
+    for(auto i(mBegin); i != mEnd;)
+    {
+        auto j(std::next(i));
+        while(j != mEnd && !mLess(*i, *j)) ++j;
+
+        auto& kept(mPolicy == VecDupPolicy::KeepLast ? *std::prev(j) : *i);
+        if(&*unique != &kept) *unique = std::move(kept);
+        ++unique;
+        i = j;
+    }
+
+    return unique;
+}
+
+/// @brief Collects unsorted items, inserting them in a vector-based sorted
+/// container with a single bulk insertion on `commit()`.
+/// @details Items that were added but not committed are discarded on
+/// destruction.
+template <typename TDerived, typename TItem>
+class VecBulkBuilder
+{
+private:
+    TDerived& container;
+    std::vector<TItem> items;
+    VecDupPolicy policy;
+
+public:
+    inline VecBulkBuilder(TDerived& mContainer, VecDupPolicy mPolicy)
+        : container(mContainer), policy{mPolicy}
+    {
+    }
+
+    /// @brief Adds an item, constructed with `mArgs`.
+    template <typename... TArgs>
+    inline auto& add(TArgs&&... mArgs)
+    {
+        items.emplace_back(FWD(mArgs)...);
+        return *this;
+    }
+
+    inline void reserve(std::size_t mV)
+    {
+        items.reserve(mV);
+    }
+    inline auto size() const noexcept
+    {
+        return items.size();
+    }
+
+    /// @brief Inserts the added items in the container, and clears the
+    /// builder.
+    inline void commit()
+    {
+        container.insertBulk(std::make_move_iterator(std::begin(items)),
+            std::make_move_iterator(std::end(items)), policy);
+        items.clear();
+    }
+};
+
 /// @brief Base CRTP class for vector-based sorted containers.
 template <typename TDerived>
 class VecMapBase
@@ -25,6 +124,53 @@ private:
         return castUp<TDerived>(*this);
     }
 
+    // Internal vector storage, without dropping the index
+    inline auto& getVec() noexcept
+    {
+        return getTD().data;
+    }
+    inline const auto& getVec() const noexcept
+    {
+        return getTD().data;
+    }
+
+    /// @brief Sorts the items appended after the first `mOldSize` ones,
+    /// resolves the duplicates, and merges them with the others.
+    inline void mergeTail(std::size_t mOldSize, VecDupPolicy mPolicy)
+    {
+        auto& d(getVec());
+        auto less([this](const auto& mA, const auto& mB)
+            {
+                return getTD().itemLess(mA, mB);
+            });
+
+        auto mid(std::begin(d) + mOldSize), last(std::end(d));
+        auto unique(sortUnique(mid, last, less, mPolicy));
+
+        // Resolve the new items equivalent to existing ones in place
+        auto first(std::begin(d)), out(mid);
+        for(auto i(mid); i != unique; ++i)
+        {
+            first = std::lower_bound(first, mid, *i, less);
+            if(first != mid && !less(*i, *first))
+            {
+                if(mPolicy == VecDupPolicy::KeepLast) *first = std::move(*i);
+                continue;
+            }
+
+            if(out != i) *out = std::move(*i);
+            ++out;
+        }
+
+        d.erase(out, last);
+        std::inplace_merge(
+            std::begin(d), std::begin(d) + mOldSize, std::end(d), less);
+
+        using IndexType = decltype(getTD().index);
+        if constexpr(IndexType::supported)
+            if(hasIndex()) buildIndex();
+    }
+
 public:
     /// @brief Returns whether or not `mValue` is present in the
     /// container.
@@ -34,21 +180,88 @@ public:
         return getTD().is(getTD().lookup(mValue), mValue);
     }
 
-    // Getters for the internal vector storage
+    /// @brief Inserts the items in [`mBegin`, `mEnd`), in any order.
+    /// @details The items are appended, sorted and merged with the
+    /// existing ones in a single pass: inserting `k` items in a container
+    /// of size `n` costs O(n + k log k), instead of O(n * k) for `k`
+    /// single insertions. Items with equivalent keys, either in the range
+    /// or already in the container, are resolved according to `mPolicy`.
+    /// The lookup index, if built, is rebuilt.
+    template <typename TItr>
+    inline void insertBulk(TItr mBegin, TItr mEnd,
+        VecDupPolicy mPolicy = VecDupPolicy::KeepLast)
+    {
+        auto oldSize(getVec().size());
+        getVec().insert(std::end(getVec()), mBegin, mEnd);
+        mergeTail(oldSize, mPolicy);
+    }
+
+    /// @brief Inserts the items of `mRange`, in any order. Items are moved
+    /// if `mRange` is an rvalue. See `insertBulk(mBegin, mEnd, mPolicy)`.
+    template <typename TRange>
+    inline void insertBulk(
+        TRange&& mRange, VecDupPolicy mPolicy = VecDupPolicy::KeepLast)
+    {
+        if constexpr(std::is_lvalue_reference<TRange>{})
+            insertBulk(std::begin(mRange), std::end(mRange), mPolicy);
+        else
+            insertBulk(std::make_move_iterator(std::begin(mRange)),
+                std::make_move_iterator(std::end(mRange)), mPolicy);
+    }
+
+    /// @brief Returns a builder that collects unsorted items, inserting
+    /// them with a single bulk insertion on `commit()`.
+    inline auto bulkBuilder(VecDupPolicy mPolicy = VecDupPolicy::KeepLast)
+    {
+        using Item = typename TDerived::Item;
+        return VecBulkBuilder<TDerived, Item>{getTD(), mPolicy};
+    }
+
+    /// @brief Builds a read-optimized index of the keys, used by lookups
+    /// instead of a binary search over the vector. See `EytzingerIndex`.
+    /// @details Meant for large, read-heavy containers with trivially
+    /// copyable keys, e.g. integers. The index is
+    /// dropped by single insertions, `clear()` and non-const `getData()`,
+    /// and rebuilt by bulk insertions. Iteration order is not affected.
+    inline void buildIndex()
+    {
+        auto& td(getTD());
+        td.index.build(td.data.size(), [&td](std::size_t mI) -> const auto&
+            {
+                return TDerived::getKey(td.data[mI]);
+            });
+    }
+
+    /// @brief Drops the lookup index, releasing its memory.
+    inline void dropIndex() noexcept
+    {
+        getTD().index.clear();
+    }
+
+    inline bool hasIndex() const noexcept
+    {
+        return getTD().index.isBuilt();
+    }
+
+    /// @brief Returns the internal vector storage. Drops the lookup index,
+    /// as the vector may be modified.
     inline auto& getData() noexcept
     {
-        return getTD().data;
+        dropIndex();
+        return getVec();
     }
+
+    /// @brief Returns the internal vector storage.
     inline const auto& getData() const noexcept
     {
-        return getTD().data;
+        return getVec();
     }
 
     // Equality/inequality
     template <typename TC>
     inline auto SSVU_ATTRIBUTE(pure) operator==(const TC& mC) const noexcept
     {
-        return getData() == mC.getData();
+        return getVec() == mC.getData();
     }
     template <typename TC>
     inline auto operator!=(const TC& mC) const noexcept
@@ -59,65 +272,66 @@ public:
     // Standard (partial) vector interface support
     inline void reserve(std::size_t mV)
     {
-        getData().reserve(mV);
+        getVec().reserve(mV);
     }
     inline void clear() noexcept
     {
-        getData().clear();
+        getVec().clear();
+        dropIndex();
     }
     inline auto size() const noexcept
     {
-        return getData().size();
+        return getVec().size();
     }
     inline auto empty() const noexcept
     {
-        return getData().empty();
+        return getVec().empty();
     }
     inline auto capacity() const noexcept
     {
-        return getData().capacity();
+        return getVec().capacity();
     }
 
     // Standard iterator support
     inline auto begin() noexcept
     {
-        return std::begin(getData());
+        return std::begin(getVec());
     }
     inline auto end() noexcept
     {
-        return std::end(getData());
+        return std::end(getVec());
     }
     inline auto begin() const noexcept
     {
-        return std::begin(getData());
+        return std::begin(getVec());
     }
     inline auto end() const noexcept
     {
-        return std::end(getData());
+        return std::end(getVec());
     }
     inline auto cbegin() const noexcept
     {
-        return std::cbegin(getData());
+        return std::cbegin(getVec());
     }
     inline auto cend() const noexcept
     {
-        return std::cend(getData());
+        return std::cend(getVec());
     }
     inline auto rbegin() noexcept
     {
-        return std::rbegin(getData());
+        return std::rbegin(getVec());
     }
     inline auto rend() noexcept
     {
-        return std::rend(getData());
+        return std::rend(getVec());
     }
     inline auto crbegin() const noexcept
     {
-        return std::crbegin(getData());
+        return std::crbegin(getVec());
     }
     inline auto crend() const noexcept
     {
-        return std::crend(getData());
+        return std::crend(getVec());
     }
 };
 } // namespace Impl
@@ -0,0 +1,471 @@
+// Copyright (c) 2013-2015 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: http://opensource.org/licenses/AFL-3.0
+
+#ifndef SSVU_IMPL_CONTAINER_VECMAPSOA
+#define SSVU_IMPL_CONTAINER_VECMAPSOA
+
+#include "SSVUtils/Container/Inc/EytzingerIndex.hpp"
+#include "SSVUtils/Container/Inc/VecMapBase.hpp"
+#include "SSVUtils/Core/Utils/Containers.hpp"
+
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ssvu
+{
+namespace Impl
+{
+/// @brief Key/value pair of a `VecMapSoA`, referring to its storage.
+template <typename TK, typename TV>
+struct VecMapSoARef
+{
+    const TK& first;
+    TV& second;
+};
+
+/// @brief Random-access iterator over a `VecMapSoA`, yielding
+/// `VecMapSoARef` proxies by value.
+template <typename TK, typename TV>
+class VecMapSoAItr
+{
+    template <typename, typename>
+    friend class VecMapSoAItr;
+
+private:
+    using Ref = VecMapSoARef<TK, TV>;
+
+    const TK* key;
+    TV* value;
+
+    // Makes `itr->first` work with proxies returned by value
+    struct Arrow
+    {
+        Ref ref;
+
+        inline auto operator-> () noexcept
+        {
+            return &ref;
+        }
+    };
+
+public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = Ref;
+    using difference_type = std::ptrdiff_t;
+    using pointer = Arrow;
+    using reference = Ref;
+
+    inline VecMapSoAItr(const TK* mKey, TV* mValue) noexcept
+        : key{mKey}, value{mValue}
+    {
+    }
+
+    // Conversion from non-const to const iterators
+    template <typename TVV,
+        typename = std::enable_if_t<std::is_same<const TVV, TV>{} &&
+                                    !std::is_same<TVV, TV>{}>>
+    inline VecMapSoAItr(const VecMapSoAItr<TK, TVV>& mX) noexcept
+        : key{mX.key}, value{mX.value}
+    {
+    }
+
+    inline auto operator*() const noexcept
+    {
+        return Ref{*key, *value};
+    }
+    inline auto operator-> () const noexcept
+    {
+        return Arrow{Ref{*key, *value}};
+    }
+    inline auto operator[](difference_type mI) const noexcept
+    {
+        return Ref{key[mI], value[mI]};
+    }
+
+    inline auto& operator++() noexcept
+    {
+        ++key;
+        ++value;
+        return *this;
+    }
+    inline auto operator++(int) noexcept
+    {
+        auto result(*this);
+        ++(*this);
+        return result;
+    }
+    inline auto& operator--() noexcept
+    {
+        --key;
+        --value;
+        return *this;
+    }
+    inline auto operator--(int) noexcept
+    {
+        auto result(*this);
+        --(*this);
+        return result;
+    }
+
+    inline auto& operator+=(difference_type mOffset) noexcept
+    {
+        key += mOffset;
+        value += mOffset;
+        return *this;
+    }
+    inline auto& operator-=(difference_type mOffset) noexcept
+    {
+        return *this += -mOffset;
+    }
+    inline auto operator+(difference_type mOffset) const noexcept
+    {
+        auto result(*this);
+        return result += mOffset;
+    }
+    inline auto operator-(difference_type mOffset) const noexcept
+    {
+        auto result(*this);
+        return result -= mOffset;
+    }
+    inline difference_type operator-(const VecMapSoAItr& mRhs) const noexcept
+    {
+        return key - mRhs.key;
+    }
+
+    inline bool operator==(const VecMapSoAItr& mRhs) const noexcept
+    {
+        return key == mRhs.key;
+    }
+    inline bool operator!=(const VecMapSoAItr& mRhs) const noexcept
+    {
+        return key != mRhs.key;
+    }
+    inline bool operator<(const VecMapSoAItr& mRhs) const noexcept
+    {
+        return key < mRhs.key;
+    }
+    inline bool operator>(const VecMapSoAItr& mRhs) const noexcept
+    {
+        return key > mRhs.key;
+    }
+    inline bool operator<=(const VecMapSoAItr& mRhs) const noexcept
+    {
+        return key <= mRhs.key;
+    }
+    inline bool operator>=(const VecMapSoAItr& mRhs) const noexcept
+    {
+        return key >= mRhs.key;
+    }
+};
+} // namespace Impl
+
+/// @brief Map-like sorted container implemented on top of two parallel
+/// `std::vector`s, one for the keys and one for the values.
+/// @details Lookups only touch the key vector, and values can be iterated
+/// densely through `getValues()`, which is worthwhile for large values.
+/// Iterators yield `{first, second}` proxies by value: use `auto&&` or
+/// `const auto&` to bind them.
+/// @tparam TK Key type.
+/// @tparam TV Value type.
+template <typename TK, typename TV>
+class VecMap<TK, TV, VecMapLayoutSoA>
+{
+public:
+    /// @typedef Type of the items accepted by bulk insertions.
+    using Item = std::pair<TK, TV>;
+
+    using iterator = Impl::VecMapSoAItr<TK, TV>;
+    using const_iterator = Impl::VecMapSoAItr<TK, const TV>;
+
+private:
+    std::vector<TK> keys;
+    std::vector<TV> values;
+    Impl::EytzingerIndex<TK> index;
+
+    inline static bool keyLess(const TK& mA, const TK& mB) noexcept
+    {
+        return mA < mB;
+    }
+
+    // Returns the position of the first key not less than `mKey`
+    inline std::size_t lookup(const TK& mKey) const noexcept
+    {
+        if(index.isBuilt()) return index.lowerBound(mKey, &keyLess);
+        return lowerBound(keys, mKey) - std::begin(keys);
+    }
+
+    // Returns validity of a looked-up position
+    inline bool is(std::size_t mI, const TK& mKey) const noexcept
+    {
+        return mI != keys.size() && keys[mI] == mKey;
+    }
+
+public:
+    inline VecMap() = default;
+    inline VecMap(std::initializer_list<Item> mIL)
+    {
+        insertBulk(std::begin(mIL), std::end(mIL));
+    }
+
+    inline std::size_t count(const TK& mKey) const noexcept
+    {
+        return is(lookup(mKey), mKey) ? 1 : 0;
+    }
+
+    /// @brief Returns whether or not the key `mKey` is present in the
+    /// container.
+    inline bool has(const TK& mKey) const noexcept
+    {
+        return is(lookup(mKey), mKey);
+    }
+
+    /// @brief Returns a non-const reference to the value with key `mKey`.
+    /// The key/value pair is created if unexistant, dropping the lookup
+    /// index.
+    template <typename TTK>
+    inline auto& operator[](TTK&& mKey)
+    {
+        auto i(lookup(mKey));
+        if(is(i, mKey)) return values[i];
+
+        // The value is inserted first, and removed if inserting the key
+        // throws, so that the two vectors always have the same size
+        index.clear();
+        auto itr(values.emplace(std::begin(values) + i));
+        try
+        {
+            keys.emplace(std::begin(keys) + i, FWD(mKey));
+        }
+        catch(...)
+        {
+            values.erase(itr);
+            throw;
+        }
+
+        return values[i];
+    }
+
+    /// @brief Returns a const reference to the value with key `mKey`. An
+    /// exception is thrown if unexistant.
+    inline const auto& at(const TK& mKey) const
+    {
+        auto i(lookup(mKey));
+        if(is(i, mKey)) return values[i];
+
+        throw std::out_of_range{""};
+    }
+
+    /// @brief Returns a const reference to the value with key `mKey`. A
+    /// default-constructed static `TV` is returned if unexistant.
+    inline const auto& atOrDefault(const TK& mKey) const noexcept
+    {
+        static TV defValue;
+
+        auto i(lookup(mKey));
+        if(is(i, mKey)) return values[i];
+        return defValue;
+    }
+
+    /// @brief Returns an iterator to the pair with key `mKey`. A
+    /// past-the-end iterator is returned if unexistant.
+    inline auto atItr(const TK& mKey) const noexcept
+    {
+        auto i(lookup(mKey));
+        return is(i, mKey) ? begin() + i : end();
+    }
+
+    /// @brief Inserts the key/value pairs in [`mBegin`, `mEnd`), in any
+    /// order. See `Impl::VecMapBase::insertBulk`.
+    /// @details The new pairs are sorted on their own, then merged with the
+    /// existing ones from the back, in place.
+    template <typename TItr>
+    inline void insertBulk(TItr mBegin, TItr mEnd,
+        VecDupPolicy mPolicy = VecDupPolicy::KeepLast)
+    {
+        std::vector<Item> items(mBegin, mEnd);
+        auto less([](const Item& mA, const Item& mB)
+            {
+                return keyLess(mA.first, mB.first);
+            });
+
+        auto unique(Impl::sortUnique(
+            std::begin(items), std::end(items), less, mPolicy));
+
+        // Resolve the new pairs equivalent to existing ones in place
+        auto first(std::begin(keys));
+        auto out(std::begin(items));
+        for(auto i(std::begin(items)); i != unique; ++i)
+        {
+            first = std::lower_bound(first, std::end(keys), i->first);
+            if(first != std::end(keys) && !keyLess(i->first, *first))
+            {
+                if(mPolicy == VecDupPolicy::KeepLast)
+                    values[first - std::begin(keys)] = std::move(i->second);
+                continue;
+            }
+
+            if(out != i) *out = std::move(*i);
+            ++out;
+        }
+
+        auto n(keys.size()), k(std::size_t(out - std::begin(items)));
+        if(k == 0) return;
+
+        values.resize(n + k);
+        try
+        {
+            keys.resize(n + k);
+        }
+        catch(...)
+        {
+            values.resize(n);
+            throw;
+        }
+
+        // Merge from the back, so that no pair is moved twice
+        for(auto o(n + k); k > 0;)
+        {
+            --o;
+            if(n > 0 && keyLess(items[k - 1].first, keys[n - 1]))
+            {
+                --n;
+                keys[o] = std::move(keys[n]);
+                values[o] = std::move(values[n]);
+                continue;
+            }
+
+            --k;
+            keys[o] = std::move(items[k].first);
+            values[o] = std::move(items[k].second);
+        }
+
+        if constexpr(Impl::EytzingerIndex<TK>::supported)
+            if(hasIndex()) buildIndex();
+    }
+
+    /// @brief Inserts the key/value pairs of `mRange`, in any order.
+    template <typename TRange>
+    inline void insertBulk(
+        TRange&& mRange, VecDupPolicy mPolicy = VecDupPolicy::KeepLast)
+    {
+        if constexpr(std::is_lvalue_reference<TRange>{})
+            insertBulk(std::begin(mRange), std::end(mRange), mPolicy);
+        else
+            insertBulk(std::make_move_iterator(std::begin(mRange)),
+                std::make_move_iterator(std::end(mRange)), mPolicy);
+    }
+
+    /// @brief Returns a builder that collects unsorted key/value pairs,
+    /// inserting them with a single bulk insertion on `commit()`.
+    inline auto bulkBuilder(VecDupPolicy mPolicy = VecDupPolicy::KeepLast)
+    {
+        return Impl::VecBulkBuilder<VecMap, Item>{*this, mPolicy};
+    }
+
+    /// @brief Builds a read-optimized index of the keys. See
+    /// `Impl::VecMapBase::buildIndex`.
+    inline void buildIndex()
+    {
+        index.build(keys.size(), [this](std::size_t mI) -> const auto&
+            {
+                return keys[mI];
+            });
+    }
+    inline void dropIndex() noexcept
+    {
+        index.clear();
+    }
+    inline bool hasIndex() const noexcept
+    {
+        return index.isBuilt();
+    }
+
+    // Getters for the internal vector storage. Keys cannot be modified, as
+    // they must stay sorted
+    inline const auto& getKeys() const noexcept
+    {
+        return keys;
+    }
+    inline auto& getValues() noexcept
+    {
+        return values;
+    }
+    inline const auto& getValues() const noexcept
+    {
+        return values;
+    }
+
+    // Equality/inequality
+    inline bool operator==(const VecMap& mC) const noexcept
+    {
+        return keys == mC.keys && values == mC.values;
+    }
+    inline bool operator!=(const VecMap& mC) const noexcept
+    {
+        return !(operator==(mC));
+    }
+
+    // Standard (partial) vector interface support
+    inline void reserve(std::size_t mV)
+    {
+        keys.reserve(mV);
+        values.reserve(mV);
+    }
+    inline void clear() noexcept
+    {
+        keys.clear();
+        values.clear();
+        index.clear();
+    }
+    inline auto size() const noexcept
+    {
+        return keys.size();
+    }
+    inline auto empty() const noexcept
+    {
+        return keys.empty();
+    }
+    inline auto capacity() const noexcept
+    {
+        return keys.capacity();
+    }
+
+    // Standard iterator support
+    inline auto begin() noexcept
+    {
+        return iterator{keys.data(), values.data()};
+    }
+    inline auto end() noexcept
+    {
+        return begin() + keys.size();
+    }
+    inline auto begin() const noexcept
+    {
+        return const_iterator{keys.data(), values.data()};
+    }
+    inline auto end() const noexcept
+    {
+        return begin() + keys.size();
+    }
+    inline auto cbegin() const noexcept
+    {
+        return begin();
+    }
+    inline auto cend() const noexcept
+    {
+        return end();
+    }
+};
+
+/// @typedef `VecMap` storing keys and values in parallel vectors.
+template <typename TK, typename TV>
+using VecMapSoA = VecMap<TK, TV, VecMapLayoutSoA>;
+} // namespace ssvu
+
+#endif
@@ -5,6 +5,7 @@
 #ifndef SSVU_IMPL_CONTAINER_VECSORTED
 #define SSVU_IMPL_CONTAINER_VECSORTED
 
+#include "SSVUtils/Container/Inc/EytzingerIndex.hpp"
 #include "SSVUtils/Container/Inc/VecMapBase.hpp"
 
 #include <vector>
@@ -18,19 +19,33 @@ namespace ssvu
 /// @tparam T Value type.
 /// @tparam TCmp Comparer type.
 template <typename T, typename TCmp = std::less<T>>
-class VecSorted : public Impl::VecMapBase<VecSorted<T>>
+class VecSorted : public Impl::VecMapBase<VecSorted<T, TCmp>>
 {
     template <typename>
     friend class Impl::VecMapBase;
 
+public:
+    /// @typedef Type of object stored in the internal vector.
+    using Item = T;
+
 private:
     std::vector<T> data;
+    Impl::EytzingerIndex<T> index;
     TCmp cmp{};
 
+    inline static const auto& getKey(const T& mX) noexcept
+    {
+        return mX;
+    }
+
     // Value lookup helper
     template <typename TT>
     inline static auto lookupHelper(TT& mVecSorted, const T& mX) noexcept
     {
+        if(mVecSorted.index.isBuilt())
+            return std::begin(mVecSorted.data) +
+                   mVecSorted.index.lowerBound(mX, mVecSorted.cmp);
+
         return lowerBound(mVecSorted.data, mX, mVecSorted.cmp);
     }
 
@@ -43,19 +58,27 @@ private:
         return lookupHelper(*this, mX);
     }
 
+    // Ordering of the stored items, used by bulk insertions
+    inline bool itemLess(const T& mA, const T& mB) const noexcept
+    {
+        return cmp(mA, mB);
+    }
+
     // Returns validity of a looked-up object
     template <typename TT>
     inline bool is(const TT& mItr, const T& mX) const noexcept
     {
-        return mItr != std::end(data) && mItr == mX;
+        return mItr != std::end(data) && !cmp(mX, *mItr);
     }
 
 public:
     inline VecSorted() = default;
-    inline VecSorted(const VecSorted& mVM) : data{mVM.data}
+    inline VecSorted(const VecSorted& mVM)
+        : data{mVM.data}, index{mVM.index}
     {
     }
-    inline VecSorted(VecSorted&& mVM) noexcept : data{std::move(mVM.data)}
+    inline VecSorted(VecSorted&& mVM) noexcept
+        : data{std::move(mVM.data)}, index{std::move(mVM.index)}
     {
     }
     inline VecSorted(std::initializer_list<T>&& mIL) : data{std::move(mIL)}
@@ -66,20 +89,23 @@ public:
     inline auto& operator=(const VecSorted& mVS)
     {
         data = mVS.data;
+        index = mVS.index;
         return *this;
     }
     inline auto& operator=(VecSorted&& mVS) noexcept
     {
         data = std::move(mVS.data);
+        index = std::move(mVS.index);
         return *this;
     }
 
-    /// @brief Inserts a value in the sorted vector. Returns an iterator to
-    /// the emplaced value.
+    /// @brief Inserts a value in the sorted vector, dropping the lookup
+    /// index. Returns an iterator to the emplaced value.
     template <typename TT>
     inline auto insert(TT&& mX)
     {
         auto itr(lookup(mX));
+        index.clear();
         return data.emplace(itr, FWD(mX));
     }
 
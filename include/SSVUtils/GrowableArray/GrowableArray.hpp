@@ -6,27 +6,86 @@
 #define SSVU_GROWABLEARRAY
 
 #include "SSVUtils/Core/Common/Casts.hpp"
+#include "SSVUtils/GrowableArray/Internal/MemoryImpl.hpp"
 
+#include <cstddef>
 #include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 namespace ssvu
 {
-/// @brief Low-level array unique ptr wrapper.
-/// @details Wraps a `std::unique_ptr<T[]>` instance and provides functions to
-/// retrieve items and grow the buffer size. `T` must be movable in order to use
-/// the `grow` function.
+/// @brief Low-level growable array.
+/// @details Owns a buffer of `T` items and provides functions to retrieve
+/// items and grow the buffer size. `T` must be movable in order to use the
+/// `grow` function.
+/// Trivially relocatable types (see `GrowableArray::relocatable`) are
+/// stored in raw memory, that is resized in place when possible and
+/// relocated with `memcpy` otherwise: see `Impl::GAMemory`. New items are
+/// not value-initialized if `T` is trivially default constructible. Other
+/// types are stored in a `new[]` array, and moved item by item.
 template <typename T>
 class GrowableArray
 {
+public:
+    /// @brief True if items are relocated by copying their bytes.
+    static constexpr bool relocatable{std::is_trivially_copyable_v<T> &&
+                                      alignof(T) <= alignof(std::max_align_t)};
+
 private:
-    std::unique_ptr<T[]> data;
+    T* data{nullptr};
+    std::size_t capacity{0};
+
+    inline void release() noexcept
+    {
+        if constexpr(relocatable)
+            Impl::GAMemory::deallocate(data, capacity * sizeof(T));
+        else
+            delete[] data;
+    }
+
+    inline void resizeImpl(std::size_t mCount, std::size_t mCapacityNew)
+    {
+        if constexpr(relocatable)
+        {
+            data = static_cast<T*>(Impl::GAMemory::reallocate(
+                data, capacity * sizeof(T), mCapacityNew * sizeof(T)));
+
+            if constexpr(!std::is_trivially_default_constructible_v<T>)
+                for(auto i(capacity); i < mCapacityNew; ++i) new(&data[i]) T();
+        }
+        else
+        {
+            auto newData(std::make_unique<T[]>(mCapacityNew));
+            for(auto i(0u); i < mCount; ++i) newData[i] = std::move(data[i]);
+
+            delete[] data;
+            data = newData.release();
+        }
+
+        capacity = mCapacityNew;
+    }
 
 public:
     inline GrowableArray() noexcept = default;
-    inline ~GrowableArray() noexcept = default;
+    inline ~GrowableArray() noexcept
+    {
+        release();
+    }
 
-    inline GrowableArray(GrowableArray&&) noexcept = default;
-    inline GrowableArray& operator=(GrowableArray&&) noexcept = default;
+    inline GrowableArray(GrowableArray&& mGA) noexcept
+        : data{mGA.data}, capacity{mGA.capacity}
+    {
+        mGA.data = nullptr;
+        mGA.capacity = 0;
+    }
+    inline GrowableArray& operator=(GrowableArray&& mGA) noexcept
+    {
+        std::swap(data, mGA.data);
+        std::swap(capacity, mGA.capacity);
+        return *this;
+    }
 
     inline GrowableArray(const GrowableArray&) = delete;
     inline GrowableArray& operator=(const GrowableArray&) = delete;
@@ -37,10 +96,19 @@ public:
     inline void grow(std::size_t mCapacityOld, std::size_t mCapacityNew)
     {
         SSVU_ASSERT(mCapacityOld <= mCapacityNew);
+        SSVU_ASSERT(mCapacityOld == capacity);
+
+        resizeImpl(mCapacityOld, mCapacityNew);
+    }
+
+    /// @brief Shrinks the internal storage to `mCapacityNew`, keeping the
+    /// first `mCount` items.
+    /// @details `mCount` must be lower or equal than the new capacity.
+    inline void shrink(std::size_t mCount, std::size_t mCapacityNew)
+    {
+        SSVU_ASSERT(mCount <= mCapacityNew);
 
-        auto newData(std::make_unique<T[]>(mCapacityNew));
-        for(auto i(0u); i < mCapacityOld; ++i) newData[i] = std::move(data[i]);
-        data = std::move(newData);
+        resizeImpl(mCount, mCapacityNew);
     }
 
     // Getters
@@ -54,7 +122,11 @@ public:
     }
     inline auto getDataPtr() noexcept
     {
-        return data.get();
+        return data;
+    }
+    inline auto getCapacity() const noexcept
+    {
+        return capacity;
     }
     inline T& operator[](std::size_t mI) noexcept
     {
@@ -66,23 +138,149 @@ public:
     }
 };
 
-/// @brief Low-level growable array storage class.
-/// @details Data must be explicitly constructed and destroyed.
+#if defined(SSVU_GROWABLEARRAY_VM)
+/// @brief Low-level growable array with stable item addresses.
+/// @details Reserves a big range of address space on the first growth
+/// (`Impl::GAVirtual::reserveBytes`), and commits its pages as the capacity
+/// grows: items are never moved or copied, and pointers to them stay valid
+/// until the array is destroyed or shrunk past them. Growing costs
+/// O(new pages). The capacity is limited by the size of the reserved
+/// range. New items are value-initialized if `T` is not trivially default
+/// constructible, and are left as found in the committed pages otherwise.
 template <typename T>
-class GrowableArrayAS
+class GrowableArrayVM
 {
+public:
+    /// @brief Maximum capacity of the array.
+    static constexpr std::size_t maxCapacity{
+        Impl::GAVirtual::reserveBytes / sizeof(T)};
+
 private:
-    GrowableArray<AlignedStorageFor<T>> data;
+    T* data{nullptr};
+    std::size_t capacity{0};
+
+    inline void destroy(std::size_t mBegin, std::size_t mEnd) noexcept
+    {
+        if constexpr(!std::is_trivially_destructible_v<T>)
+            for(auto i(mBegin); i < mEnd; ++i) data[i].~T();
+    }
 
 public:
-    inline GrowableArrayAS() noexcept = default;
-    inline ~GrowableArrayAS() noexcept = default;
+    inline GrowableArrayVM() noexcept = default;
+    inline ~GrowableArrayVM() noexcept
+    {
+        destroy(0, capacity);
+        Impl::GAVirtual::release(data, Impl::GAVirtual::reserveBytes);
+    }
 
-    inline GrowableArrayAS(GrowableArrayAS&& mGA) noexcept = default;
-    inline GrowableArrayAS& operator=(GrowableArrayAS&& mGA) noexcept = default;
+    inline GrowableArrayVM(GrowableArrayVM&& mGA) noexcept
+        : data{mGA.data}, capacity{mGA.capacity}
+    {
+        mGA.data = nullptr;
+        mGA.capacity = 0;
+    }
+    inline GrowableArrayVM& operator=(GrowableArrayVM&& mGA) noexcept
+    {
+        std::swap(data, mGA.data);
+        std::swap(capacity, mGA.capacity);
+        return *this;
+    }
 
-    inline GrowableArrayAS(const GrowableArrayAS& mGA) = delete;
-    inline auto& operator=(const GrowableArrayAS& mGA) = delete;
+    inline GrowableArrayVM(const GrowableArrayVM&) = delete;
+    inline GrowableArrayVM& operator=(const GrowableArrayVM&) = delete;
+
+    /// @brief Grows the internal storage from `mCapacityOld` to
+    /// `mCapacityNew`, without moving the items.
+    /// @details The new capacity must be greater or equal than the old one,
+    /// and lower or equal than `maxCapacity`.
+    inline void grow(std::size_t mCapacityOld, std::size_t mCapacityNew)
+    {
+        SSVU_ASSERT(mCapacityOld <= mCapacityNew);
+        SSVU_ASSERT(mCapacityOld == capacity);
+        if(mCapacityNew > maxCapacity) throw std::bad_alloc{};
+
+        if(data == nullptr)
+            data = static_cast<T*>(
+                Impl::GAVirtual::reserve(Impl::GAVirtual::reserveBytes));
+
+        Impl::GAVirtual::commit(
+            data, capacity * sizeof(T), mCapacityNew * sizeof(T));
+
+        if constexpr(!std::is_trivially_default_constructible_v<T>)
+            for(auto i(capacity); i < mCapacityNew; ++i) new(&data[i]) T();
+
+        capacity = mCapacityNew;
+    }
+
+    /// @brief Shrinks the internal storage to `mCapacityNew`, keeping the
+    /// first `mCount` items in place. Unused pages are returned to the
+    /// system.
+    /// @details `mCount` must be lower or equal than the new capacity.
+    inline void shrink(std::size_t mCount, std::size_t mCapacityNew)
+    {
+        SSVU_ASSERT(mCount <= mCapacityNew);
+        if(mCapacityNew >= capacity) return;
+
+        destroy(mCapacityNew, capacity);
+        Impl::GAVirtual::decommit(
+            data, capacity * sizeof(T), mCapacityNew * sizeof(T));
+        capacity = mCapacityNew;
+    }
+
+    // Getters
+    inline auto& getData() noexcept
+    {
+        return data;
+    }
+    inline const auto& getData() const noexcept
+    {
+        return data;
+    }
+    inline auto getDataPtr() noexcept
+    {
+        return data;
+    }
+    inline auto getCapacity() const noexcept
+    {
+        return capacity;
+    }
+    inline T& operator[](std::size_t mI) noexcept
+    {
+        return data[mI];
+    }
+    inline const T& operator[](std::size_t mI) const noexcept
+    {
+        return data[mI];
+    }
+};
+#else
+/// @brief Fallback for systems without virtual memory functions: item
+/// addresses are not stable.
+template <typename T>
+using GrowableArrayVM = GrowableArray<T>;
+#endif
+
+namespace Impl
+{
+/// @brief Low-level growable array storage class, over the growable array
+/// type `TArray`.
+/// @details Data must be explicitly constructed and destroyed.
+template <typename T, template <typename> class TArray>
+class GrowableArrayASImpl
+{
+private:
+    TArray<AlignedStorageFor<T>> data;
+
+public:
+    inline GrowableArrayASImpl() noexcept = default;
+    inline ~GrowableArrayASImpl() noexcept = default;
+
+    inline GrowableArrayASImpl(GrowableArrayASImpl&&) noexcept = default;
+    inline GrowableArrayASImpl& operator=(
+        GrowableArrayASImpl&&) noexcept = default;
+
+    inline GrowableArrayASImpl(const GrowableArrayASImpl&) = delete;
+    inline auto& operator=(const GrowableArrayASImpl&) = delete;
 
     /// @brief Grows the internal storage from `mCapacityOld` to
     /// `mCapacityNew`.
@@ -92,6 +290,14 @@ public:
         data.grow(mCapacityOld, mCapacityNew);
     }
 
+    /// @brief Shrinks the internal storage to `mCapacityNew`, keeping the
+    /// first `mCount` items.
+    /// @details `mCount` must be lower or equal than the new capacity.
+    inline void shrink(std::size_t mCount, std::size_t mCapacityNew)
+    {
+        data.shrink(mCount, mCapacityNew);
+    }
+
     /// @brief Constructs a `T` instance at index `mI`.
     template <typename... TArgs>
     inline void initAt(std::size_t mI, TArgs&&... mArgs) noexcept(
@@ -118,7 +324,7 @@ public:
     }
     inline auto getDataPtr() noexcept
     {
-        return data.get();
+        return castStorage<T>(data.getDataPtr());
     }
     inline T& operator[](std::size_t mI) noexcept
     {
@@ -129,6 +335,22 @@ public:
         return castStorage<T>(data[mI]);
     }
 };
+} // namespace Impl
+
+/// @brief Low-level growable array storage class.
+/// @details Data must be explicitly constructed and destroyed. Storage is
+/// trivially relocatable: growing never constructs nor moves items, it
+/// resizes raw memory (see `GrowableArray`). Items must be relocatable by
+/// copying their bytes.
+template <typename T>
+using GrowableArrayAS = Impl::GrowableArrayASImpl<T, GrowableArray>;
+
+/// @brief Low-level growable array storage class, with stable item
+/// addresses.
+/// @details Data must be explicitly constructed and destroyed. Growing
+/// never moves items: see `GrowableArrayVM`.
+template <typename T>
+using GrowableArrayVMAS = Impl::GrowableArrayASImpl<T, GrowableArrayVM>;
 } // namespace ssvu
 
 #endif
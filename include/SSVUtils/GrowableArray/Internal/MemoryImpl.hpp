@@ -0,0 +1,196 @@
+// Copyright (c) 2013-2015 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: http://opensource.org/licenses/AFL-3.0
+
+#ifndef SSVU_GROWABLEARRAY_INTERNAL_MEMORYIMPL
+#define SSVU_GROWABLEARRAY_INTERNAL_MEMORYIMPL
+
+#include "SSVUtils/Core/Assert/Assert.hpp"
+#include "SSVUtils/Core/Detection/Detection.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#if defined(SSVU_OS_LINUX) || defined(SSVU_OS_MAC)
+#include <sys/mman.h>
+#include <unistd.h>
+#define SSVU_GROWABLEARRAY_VM 1
+
+// `mremap` is Linux-specific
+#if defined(__linux__)
+#define SSVU_GROWABLEARRAY_MREMAP 1
+#endif
+#endif
+
+namespace ssvu
+{
+namespace Impl
+{
+#if defined(SSVU_GROWABLEARRAY_VM)
+/// @brief Returns the size of virtual memory pages.
+inline std::size_t getPageSize() noexcept
+{
+    static const std::size_t result(sysconf(_SC_PAGESIZE));
+    return result;
+}
+
+/// @brief Rounds `mBytes` up to a multiple of the page size.
+inline std::size_t roundToPages(std::size_t mBytes) noexcept
+{
+    auto p(getPageSize());
+    return (mBytes + p - 1) / p * p;
+}
+#endif
+
+/// @brief Raw memory functions used by `GrowableArray` for trivially
+/// relocatable types.
+/// @details Small buffers are managed with `std::malloc` and `std::realloc`,
+/// which can often grow them in place. On Linux, buffers of at least
+/// `mapThreshold` bytes are mapped directly with `mmap`, and grown with
+/// `mremap`, which moves pages in virtual memory without copying them.
+namespace GAMemory
+{
+/// @brief Size from which buffers are mapped directly, if supported.
+constexpr std::size_t mapThreshold{1024 * 1024};
+
+#if defined(SSVU_GROWABLEARRAY_MREMAP)
+inline bool isMapped(std::size_t mBytes) noexcept
+{
+    return mBytes >= mapThreshold;
+}
+#endif
+
+/// @brief Deallocates a buffer of `mBytes` bytes returned by `reallocate`.
+inline void deallocate(void* mPtr, std::size_t mBytes) noexcept
+{
+    if(mPtr == nullptr) return;
+
+#if defined(SSVU_GROWABLEARRAY_MREMAP)
+    if(isMapped(mBytes))
+    {
+        munmap(mPtr, roundToPages(mBytes));
+        return;
+    }
+#else
+    (void)mBytes;
+#endif
+
+    std::free(mPtr);
+}
+
+/// @brief Resizes a buffer from `mBytesOld` to `mBytesNew` bytes, keeping
+/// its contents. `mPtr` can be null if `mBytesOld` is zero. Throws
+/// `std::bad_alloc` on failure, leaving the buffer untouched.
+inline void* reallocate(
+    void* mPtr, std::size_t mBytesOld, std::size_t mBytesNew)
+{
+    if(mBytesNew == 0)
+    {
+        deallocate(mPtr, mBytesOld);
+        return nullptr;
+    }
+
+#if defined(SSVU_GROWABLEARRAY_MREMAP)
+    if(isMapped(mBytesOld) || isMapped(mBytesNew))
+    {
+        void* result;
+
+        if(isMapped(mBytesOld) && isMapped(mBytesNew))
+            result = mremap(mPtr, roundToPages(mBytesOld),
+                roundToPages(mBytesNew), MREMAP_MAYMOVE);
+        else if(isMapped(mBytesNew))
+            result = mmap(nullptr, roundToPages(mBytesNew),
+                PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        else
+            result = std::malloc(mBytesNew);
+
+        if(result == MAP_FAILED || result == nullptr) throw std::bad_alloc{};
+
+        // Switching between `malloc` and `mmap` requires a copy
+        if(isMapped(mBytesOld) != isMapped(mBytesNew))
+        {
+            if(mPtr != nullptr)
+                std::memcpy(result, mPtr, std::min(mBytesOld, mBytesNew));
+
+            deallocate(mPtr, mBytesOld);
+        }
+
+        return result;
+    }
+#else
+    (void)mBytesOld;
+#endif
+
+    auto result(std::realloc(mPtr, mBytesNew));
+    if(result == nullptr) throw std::bad_alloc{};
+    return result;
+}
+} // namespace GAMemory
+
+#if defined(SSVU_GROWABLEARRAY_VM)
+/// @brief Virtual memory functions used by `GrowableArrayVM`.
+/// @details An address range is reserved without backing memory
+/// (`PROT_NONE`), then its pages are committed (made accessible) as
+/// needed. Committed pages are zero-filled by the system, and only use
+/// physical memory once touched.
+namespace GAVirtual
+{
+/// @brief Size of the address range reserved by every array.
+constexpr std::size_t reserveBytes{
+    sizeof(void*) >= 8 ? std::size_t(1) << 30 : std::size_t(64) << 20};
+
+/// @brief Reserves `mBytes` bytes of address space. Throws
+/// `std::bad_alloc` on failure.
+inline void* reserve(std::size_t mBytes)
+{
+    auto flags(MAP_PRIVATE | MAP_ANONYMOUS);
+#if defined(MAP_NORESERVE)
+    flags |= MAP_NORESERVE;
+#endif
+
+    auto result(mmap(nullptr, roundToPages(mBytes), PROT_NONE, flags, -1, 0));
+    if(result == MAP_FAILED) throw std::bad_alloc{};
+    return result;
+}
+
+/// @brief Releases an address range returned by `reserve`.
+inline void release(void* mPtr, std::size_t mBytes) noexcept
+{
+    if(mPtr != nullptr) munmap(mPtr, roundToPages(mBytes));
+}
+
+/// @brief Commits the pages of a reserved range, so that its first
+/// `mBytesNew` bytes (instead of `mBytesOld`) are accessible. Throws
+/// `std::bad_alloc` on failure.
+inline void commit(void* mPtr, std::size_t mBytesOld, std::size_t mBytesNew)
+{
+    auto begin(roundToPages(mBytesOld)), end(roundToPages(mBytesNew));
+    if(begin >= end) return;
+
+    if(mprotect(static_cast<char*>(mPtr) + begin, end - begin,
+           PROT_READ | PROT_WRITE) != 0)
+        throw std::bad_alloc{};
+}
+
+/// @brief Returns the pages past the first `mBytesNew` bytes (instead of
+/// `mBytesOld`) of a reserved range to the system. Their contents are
+/// lost.
+inline void decommit(
+    void* mPtr, std::size_t mBytesOld, std::size_t mBytesNew) noexcept
+{
+    auto begin(roundToPages(mBytesNew)), end(roundToPages(mBytesOld));
+    if(begin >= end) return;
+
+    auto ptr(static_cast<char*>(mPtr) + begin);
+    madvise(ptr, end - begin, MADV_DONTNEED);
+    mprotect(ptr, end - begin, PROT_NONE);
+}
+} // namespace GAVirtual
+#endif
+} // namespace Impl
+} // namespace ssvu
+
+#endif
@@ -0,0 +1,214 @@
+// Copyright (c) 2013-2015 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: http://opensource.org/licenses/AFL-3.0
+
+#ifndef SSVU_JSON_BIN
+#define SSVU_JSON_BIN
+
+#include "SSVUtils/Core/Core.hpp"
+#include "SSVUtils/Json/Val/Internal/CnvFuncs.hpp"
+#include "SSVUtils/Json/Bin/Internal/Archive.hpp"
+#include "SSVUtils/Json/Bin/Internal/Codec.hpp"
+
+#include <cstdint>
+#include <string>
+
+namespace ssvu
+{
+namespace Json
+{
+namespace Impl
+{
+/// @brief Magic number at the beginning of every binary snapshot.
+/// @details Stored in native byte order, so that snapshots written on a
+/// host with a different endianness are rejected.
+constexpr std::uint32_t binMagic{0x424a5653u};
+
+struct BinCnvHelper
+{
+    inline static void hWriteObj(BinWriter&) noexcept
+    {
+    }
+    template <typename TKey, typename TArg, typename... TArgs>
+    inline static void hWriteObj(
+        BinWriter& mW, const TKey&, const TArg& mArg, const TArgs&... mArgs)
+    {
+        BinCodecFor<TArg>::write(mW, mArg);
+        hWriteObj(mW, mArgs...);
+    }
+
+    inline static void hReadObj(BinReader&) noexcept
+    {
+    }
+    template <typename TKey, typename TArg, typename... TArgs>
+    inline static void hReadObj(
+        BinReader& mR, const TKey&, TArg& mArg, TArgs&... mArgs)
+    {
+        BinCodecFor<TArg>::read(mR, mArg);
+        hReadObj(mR, mArgs...);
+    }
+
+    inline static void hHashObj(BinHasher&) noexcept
+    {
+    }
+    template <typename TKey, typename TArg, typename... TArgs>
+    inline static void hHashObj(
+        BinHasher& mH, const TKey& mKey, const TArg&, const TArgs&... mArgs)
+    {
+        mH.add(std::string_view{mKey});
+        BinCodecFor<TArg>::hash(mH);
+        hHashObj(mH, mArgs...);
+    }
+};
+} // namespace Impl
+
+// Binary archive overloads of the converter functions used by the
+// `SSVJ_CNV` family of macros: object keys only contribute to the schema
+// hash, and are not stored.
+
+template <typename T>
+inline void cnv(Impl::BinWriter& mW, const T& mX)
+{
+    Impl::BinCodecFor<T>::write(mW, mX);
+}
+template <typename T>
+inline void cnv(Impl::BinReader& mR, T& mX)
+{
+    Impl::BinCodecFor<T>::read(mR, mX);
+}
+template <typename T>
+inline void cnv(Impl::BinHasher& mH, const T&)
+{
+    Impl::BinCodecFor<T>::hash(mH);
+}
+
+template <typename... TArgs>
+inline void cnvArr(Impl::BinWriter& mW, const TArgs&... mArgs)
+{
+    (Impl::BinCodecFor<TArgs>::write(mW, mArgs), ...);
+}
+template <typename... TArgs>
+inline void cnvArr(Impl::BinReader& mR, TArgs&... mArgs)
+{
+    (Impl::BinCodecFor<TArgs>::read(mR, mArgs), ...);
+}
+template <typename... TArgs>
+inline void cnvArr(Impl::BinHasher& mH, const TArgs&...)
+{
+    mH.add("arr");
+    mH.add(sizeof...(TArgs));
+    (Impl::BinCodecFor<TArgs>::hash(mH), ...);
+}
+
+template <typename... TArgs>
+inline void cnvObj(Impl::BinWriter& mW, const TArgs&... mArgs)
+{
+    Impl::BinCnvHelper::hWriteObj(mW, mArgs...);
+}
+template <typename... TArgs>
+inline void cnvObj(Impl::BinReader& mR, TArgs&... mArgs)
+{
+    Impl::BinCnvHelper::hReadObj(mR, mArgs...);
+}
+template <typename... TArgs>
+inline void cnvObj(Impl::BinHasher& mH, const TArgs&... mArgs)
+{
+    mH.add("obj");
+    mH.add(sizeof...(TArgs) / 2);
+    Impl::BinCnvHelper::hHashObj(mH, mArgs...);
+}
+
+/// @brief Returns the schema hash of `T`'s binary snapshots.
+/// @details Depends on the field lists, keys and types of `T`'s converters
+/// (and of the converters of its members), not on their values.
+template <typename T>
+inline std::uint64_t getBinSchemaHash()
+{
+    static std::uint64_t result{[]
+        {
+            Impl::BinHasher h;
+            Impl::BinCodecFor<T>::hash(h);
+            return h.getHash();
+        }()};
+
+    return result;
+}
+
+/// @brief Writes a binary snapshot of `mX` to `mOut`.
+/// @details Types with macro-based converters (`SSVJ_CNV_OBJ_AUTO`,
+/// `SSVJ_CNV_ARR`, ...) are encoded field by field, using the converter's
+/// field list without building any `Val`. Integers are stored as varints,
+/// strings and vectors are length-prefixed, and contiguous sequences of
+/// arithmetic values are copied with a single `memcpy`. The snapshot
+/// starts with a header containing the schema hash of `T`.
+template <typename T>
+inline void archBin(std::string& mOut, const T& mX)
+{
+    auto hash(getBinSchemaHash<T>());
+
+    mOut.clear();
+    Impl::BinWriter w{mOut};
+    w.putBytes(&Impl::binMagic, sizeof(Impl::binMagic));
+    w.putBytes(&hash, sizeof(hash));
+    Impl::BinCodecFor<T>::write(w, mX);
+}
+
+/// @brief Returns a binary snapshot of `mX`. See `archBin`.
+template <typename T>
+inline std::string getArchBin(const T& mX)
+{
+    std::string result;
+    archBin(result, mX);
+    return result;
+}
+
+/// @brief Restores `mX` from the binary snapshot in `[mData, mData + mSize)`.
+/// @details Throws `ReadException` if the data is not a snapshot of `T`
+/// (mismatching schema hash), or if it is truncated or malformed.
+template <typename T>
+inline void extrBin(const char* mData, std::size_t mSize, T& mX)
+{
+    Impl::BinReader r{mData, mSize};
+
+    std::uint32_t magic;
+    std::uint64_t hash;
+    r.getBytes(&magic, sizeof(magic));
+    r.getBytes(&hash, sizeof(hash));
+
+    if(magic != Impl::binMagic)
+        throw ReadException{"Invalid binary snapshot",
+            "not a binary snapshot, or written with a different byte order",
+            ""};
+
+    if(hash != getBinSchemaHash<T>())
+        throw ReadException{"Invalid binary snapshot",
+            "schema hash mismatch: snapshot was written for a different type",
+            ""};
+
+    Impl::BinCodecFor<T>::read(r, mX);
+
+    if(r.getRemaining() != 0)
+        throw ReadException{
+            "Invalid binary snapshot", "unexpected trailing data", ""};
+}
+
+/// @brief Restores `mX` from the binary snapshot `mSrc`. See `extrBin`.
+template <typename T>
+inline void extrBin(const std::string& mSrc, T& mX)
+{
+    extrBin(mSrc.data(), mSrc.size(), mX);
+}
+
+/// @brief Returns a `T` restored from the binary snapshot `mSrc`. See
+/// `extrBin`.
+template <typename T>
+inline T getExtrBin(const std::string& mSrc)
+{
+    T result;
+    extrBin(mSrc, result);
+    return result;
+}
+} // namespace Json
+} // namespace ssvu
+
+#endif
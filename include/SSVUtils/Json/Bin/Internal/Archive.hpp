@@ -0,0 +1,200 @@
+// Copyright (c) 2013-2015 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: http://opensource.org/licenses/AFL-3.0
+
+#ifndef SSVU_JSON_BIN_INTERNAL_ARCHIVE
+#define SSVU_JSON_BIN_INTERNAL_ARCHIVE
+
+#include "SSVUtils/Core/Core.hpp"
+#include "SSVUtils/Json/Io/ReadException.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace ssvu
+{
+namespace Json
+{
+namespace Impl
+{
+/// @brief Appends binary snapshot data to a string.
+class BinWriter
+{
+private:
+    std::string& out;
+
+public:
+    inline BinWriter(std::string& mOut) noexcept : out(mOut)
+    {
+    }
+
+    inline void putBytes(const void* mData, std::size_t mSize)
+    {
+        out.append(static_cast<const char*>(mData), mSize);
+    }
+
+    /// @brief Writes `mX` as a LEB128 varint.
+    inline void putVarint(std::uint64_t mX)
+    {
+        char buf[10];
+        auto n(0u);
+
+        for(; mX >= 0x80; mX >>= 7) buf[n++] = char(mX | 0x80);
+        buf[n++] = char(mX);
+
+        out.append(buf, n);
+    }
+
+    /// @brief Writes `mX` as a zigzag-encoded LEB128 varint.
+    inline void putVarintS(std::int64_t mX)
+    {
+        putVarint((std::uint64_t(mX) << 1) ^ std::uint64_t(mX >> 63));
+    }
+};
+
+/// @brief Reads binary snapshot data from a memory buffer.
+/// @details Throws `ReadException` on truncated or malformed data.
+class BinReader
+{
+private:
+    const char* itr;
+    const char* end;
+
+    [[noreturn]] inline static void fail(const std::string& mWhat)
+    {
+        throw ReadException{"Invalid binary snapshot", mWhat, ""};
+    }
+
+public:
+    inline BinReader(const char* mData, std::size_t mSize) noexcept
+        : itr{mData}, end{mData + mSize}
+    {
+    }
+
+    inline auto getRemaining() const noexcept
+    {
+        return std::size_t(end - itr);
+    }
+
+    inline void getBytes(void* mData, std::size_t mSize)
+    {
+        if(mSize > getRemaining()) fail("unexpected end of data");
+
+        std::memcpy(mData, itr, mSize);
+        itr += mSize;
+    }
+
+    /// @brief Reads a LEB128 varint.
+    inline std::uint64_t getVarint()
+    {
+        std::uint64_t result{0};
+
+        for(auto shift(0u); shift < 64; shift += 7)
+        {
+            if(itr == end) fail("unexpected end of data");
+
+            auto byte(static_cast<unsigned char>(*itr++));
+
+            // The tenth byte only holds the most significant bit
+            if(shift == 63 && byte > 1) fail("varint too long");
+
+            result |= std::uint64_t(byte & 0x7f) << shift;
+            if((byte & 0x80) == 0) return result;
+        }
+
+        fail("varint too long");
+    }
+
+    /// @brief Reads a zigzag-encoded LEB128 varint.
+    inline std::int64_t getVarintS()
+    {
+        auto x(getVarint());
+        return std::int64_t(x >> 1) ^ -std::int64_t(x & 1);
+    }
+
+    /// @brief Reads an integer stored with `BinWriter::putVarint` (or
+    /// `putVarintS`, if `T` is signed), failing if it does not fit in `T`.
+    template <typename T>
+    inline T getInt()
+    {
+        if constexpr(std::is_signed_v<T>)
+        {
+            auto x(getVarintS());
+            if constexpr(sizeof(T) < sizeof(std::int64_t))
+                if(x < std::numeric_limits<T>::min() ||
+                    x > std::numeric_limits<T>::max())
+                    fail("integer out of range");
+
+            return T(x);
+        }
+        else
+        {
+            auto x(getVarint());
+            if constexpr(sizeof(T) < sizeof(std::uint64_t))
+                if(x > std::numeric_limits<T>::max())
+                    fail("integer out of range");
+
+            return T(x);
+        }
+    }
+
+    /// @brief Reads a length prefix, checking that it can be backed by the
+    /// remaining data, given that every element uses at least
+    /// `mMinElementSize` bytes.
+    inline std::size_t getSize(std::size_t mMinElementSize)
+    {
+        auto x(getVarint());
+        if(mMinElementSize != 0 && x > getRemaining() / mMinElementSize)
+            fail("length prefix exceeds the remaining data");
+
+        return std::size_t(x);
+    }
+};
+
+/// @brief Computes the schema hash of a type, by visiting its converter
+/// with type and key tokens instead of values.
+/// @details Uses 64-bit FNV-1a, so that hashes are stable between runs
+/// and implementations.
+class BinHasher
+{
+private:
+    std::uint64_t hash{0xcbf29ce484222325ull};
+
+public:
+    inline void add(const void* mData, std::size_t mSize) noexcept
+    {
+        auto p(static_cast<const unsigned char*>(mData));
+        for(auto i(0u); i < mSize; ++i)
+        {
+            hash ^= p[i];
+            hash *= 0x100000001b3ull;
+        }
+    }
+
+    inline void add(std::uint64_t mX) noexcept
+    {
+        unsigned char buf[8];
+        for(auto i(0u); i < 8; ++i) buf[i] = (mX >> (i * 8)) & 0xff;
+        add(buf, sizeof(buf));
+    }
+
+    inline void add(std::string_view mX) noexcept
+    {
+        add(mX.size());
+        add(mX.data(), mX.size());
+    }
+
+    inline auto getHash() const noexcept
+    {
+        return hash;
+    }
+};
+} // namespace Impl
+} // namespace Json
+} // namespace ssvu
+
+#endif
@@ -0,0 +1,354 @@
+// Copyright (c) 2013-2015 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: http://opensource.org/licenses/AFL-3.0
+
+#ifndef SSVU_JSON_BIN_INTERNAL_CODEC
+#define SSVU_JSON_BIN_INTERNAL_CODEC
+
+#include "SSVUtils/Core/Core.hpp"
+#include "SSVUtils/Json/Val/Internal/Cnv.hpp"
+#include "SSVUtils/Json/Bin/Internal/Archive.hpp"
+
+#include <algorithm>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ssvu
+{
+namespace Json
+{
+namespace Impl
+{
+/// @brief True if `T`'s converter was defined with the `SSVJ_CNV` family of
+/// macros, whose field lists can be reused by the binary archives.
+template <typename T>
+constexpr bool isBinCnvSimple{std::is_base_of_v<CnvImplSimple<T>, Cnv<T>>};
+
+/// @brief True if contiguous sequences of `T` are stored with a single
+/// `memcpy`.
+template <typename T>
+constexpr bool isBinRaw{
+    (std::is_arithmetic_v<T> && !std::is_same_v<T, bool>) ||
+    std::is_enum_v<T>};
+
+/// @brief Binary snapshot encoder/decoder for `T`.
+/// @details Every specialization provides `write`, `read` and `hash`.
+template <typename T, typename = void>
+struct BinCodec
+{
+    SSVU_ASSERT_STATIC(sizeof(T) == 0,
+        "Type has no binary snapshot codec: use an `SSVJ_CNV` converter");
+};
+
+/// @typedef Codec for `T`, ignoring references and cv-qualifiers.
+template <typename T>
+using BinCodecFor = BinCodec<std::remove_cv_t<std::remove_reference_t<T>>>;
+
+// Integers are stored as varints, signed ones zigzag-encoded
+template <typename T>
+struct BinCodec<T,
+    std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>>>
+{
+    inline static void write(BinWriter& mW, const T& mX)
+    {
+        if constexpr(std::is_signed_v<T>)
+            mW.putVarintS(mX);
+        else
+            mW.putVarint(mX);
+    }
+    inline static void read(BinReader& mR, T& mX)
+    {
+        mX = mR.getInt<T>();
+    }
+    inline static void hash(BinHasher& mH) noexcept
+    {
+        mH.add(std::is_signed_v<T> ? "ints" : "intu");
+        mH.add(sizeof(T));
+    }
+};
+
+// Reals are stored with their in-memory representation
+template <typename T>
+struct BinCodec<T, std::enable_if_t<std::is_floating_point_v<T>>>
+{
+    inline static void write(BinWriter& mW, const T& mX)
+    {
+        mW.putBytes(&mX, sizeof(T));
+    }
+    inline static void read(BinReader& mR, T& mX)
+    {
+        mR.getBytes(&mX, sizeof(T));
+    }
+    inline static void hash(BinHasher& mH) noexcept
+    {
+        mH.add("real");
+        mH.add(sizeof(T));
+    }
+};
+
+template <>
+struct BinCodec<bool>
+{
+    inline static void write(BinWriter& mW, const bool& mX)
+    {
+        char c(mX ? 1 : 0);
+        mW.putBytes(&c, 1);
+    }
+    inline static void read(BinReader& mR, bool& mX)
+    {
+        char c;
+        mR.getBytes(&c, 1);
+        mX = c != 0;
+    }
+    inline static void hash(BinHasher& mH) noexcept
+    {
+        mH.add("bln");
+    }
+};
+
+template <typename T>
+struct BinCodec<T, std::enable_if_t<std::is_enum_v<T>>>
+{
+    using Underlying = std::underlying_type_t<T>;
+
+    inline static void write(BinWriter& mW, const T& mX)
+    {
+        BinCodec<Underlying>::write(mW, Underlying(mX));
+    }
+    inline static void read(BinReader& mR, T& mX)
+    {
+        Underlying x;
+        BinCodec<Underlying>::read(mR, x);
+        mX = T(x);
+    }
+    inline static void hash(BinHasher& mH) noexcept
+    {
+        mH.add("enum");
+        BinCodec<Underlying>::hash(mH);
+    }
+};
+
+template <>
+struct BinCodec<Str>
+{
+    inline static void write(BinWriter& mW, const Str& mX)
+    {
+        mW.putVarint(mX.size());
+        mW.putBytes(mX.data(), mX.size());
+    }
+    inline static void read(BinReader& mR, Str& mX)
+    {
+        mX.resize(mR.getSize(1));
+        mR.getBytes(&mX[0], mX.size());
+    }
+    inline static void hash(BinHasher& mH) noexcept
+    {
+        mH.add("str");
+    }
+};
+
+/// @brief Shared implementation for contiguous sequences.
+template <typename TItem>
+struct BinSeqHelper
+{
+    inline static void write(BinWriter& mW, const TItem* mData, std::size_t mN)
+    {
+        if constexpr(isBinRaw<TItem>)
+            mW.putBytes(mData, mN * sizeof(TItem));
+        else
+            for(auto i(0u); i < mN; ++i) BinCodec<TItem>::write(mW, mData[i]);
+    }
+    inline static void read(BinReader& mR, TItem* mData, std::size_t mN)
+    {
+        if constexpr(isBinRaw<TItem>)
+            mR.getBytes(mData, mN * sizeof(TItem));
+        else
+            for(auto i(0u); i < mN; ++i) BinCodec<TItem>::read(mR, mData[i]);
+    }
+};
+
+template <typename TItem>
+struct BinCodec<std::vector<TItem>>
+{
+    using Type = std::vector<TItem>;
+
+    inline static void write(BinWriter& mW, const Type& mX)
+    {
+        mW.putVarint(mX.size());
+
+        if constexpr(std::is_same_v<TItem, bool>)
+            for(bool b : mX) BinCodec<bool>::write(mW, b);
+        else
+            BinSeqHelper<TItem>::write(mW, mX.data(), mX.size());
+    }
+    inline static void read(BinReader& mR, Type& mX)
+    {
+        if constexpr(isBinRaw<TItem>)
+        {
+            mX.resize(mR.getSize(sizeof(TItem)));
+            BinSeqHelper<TItem>::read(mR, mX.data(), mX.size());
+        }
+        else
+        {
+            auto n(mR.getSize(0));
+            mX.clear();
+            mX.reserve(std::min(n, mR.getRemaining()));
+
+            for(auto i(0u); i < n; ++i)
+            {
+                TItem item;
+                BinCodec<TItem>::read(mR, item);
+                mX.emplace_back(std::move(item));
+            }
+        }
+    }
+    inline static void hash(BinHasher& mH)
+    {
+        mH.add("vec");
+        BinCodec<TItem>::hash(mH);
+    }
+};
+
+template <typename TItem, std::size_t TS>
+struct BinCodec<TItem[TS]>
+{
+    inline static void write(BinWriter& mW, const TItem (&mX)[TS])
+    {
+        BinSeqHelper<TItem>::write(mW, mX, TS);
+    }
+    inline static void read(BinReader& mR, TItem (&mX)[TS])
+    {
+        BinSeqHelper<TItem>::read(mR, mX, TS);
+    }
+    inline static void hash(BinHasher& mH)
+    {
+        mH.add("carr");
+        mH.add(TS);
+        BinCodec<TItem>::hash(mH);
+    }
+};
+
+template <typename T1, typename T2>
+struct BinCodec<std::pair<T1, T2>>
+{
+    using Type = std::pair<T1, T2>;
+
+    inline static void write(BinWriter& mW, const Type& mX)
+    {
+        BinCodec<T1>::write(mW, mX.first);
+        BinCodec<T2>::write(mW, mX.second);
+    }
+    inline static void read(BinReader& mR, Type& mX)
+    {
+        BinCodec<T1>::read(mR, mX.first);
+        BinCodec<T2>::read(mR, mX.second);
+    }
+    inline static void hash(BinHasher& mH)
+    {
+        mH.add("pair");
+        BinCodec<T1>::hash(mH);
+        BinCodec<T2>::hash(mH);
+    }
+};
+
+template <typename... TArgs>
+struct BinCodec<std::tuple<TArgs...>>
+{
+    using Type = std::tuple<TArgs...>;
+
+    inline static void write(BinWriter& mW, const Type& mX)
+    {
+        std::apply(
+            [&mW](const auto&... mXs) {
+                (BinCodecFor<decltype(mXs)>::write(mW, mXs), ...);
+            },
+            mX);
+    }
+    inline static void read(BinReader& mR, Type& mX)
+    {
+        std::apply(
+            [&mR](auto&... mXs) {
+                (BinCodecFor<decltype(mXs)>::read(mR, mXs), ...);
+            },
+            mX);
+    }
+    inline static void hash(BinHasher& mH)
+    {
+        mH.add("tpl");
+        mH.add(sizeof...(TArgs));
+        (BinCodec<TArgs>::hash(mH), ...);
+    }
+};
+
+// Map-like containers are stored as a length-prefixed sequence of pairs
+template <typename TKey, typename TValue,
+    template <typename, typename, typename...> class TMap, typename... TExtra>
+struct BinCodec<TMap<TKey, TValue, TExtra...>,
+    ssvu::Impl::VoidT<typename TMap<TKey, TValue, TExtra...>::key_type>>
+{
+    using Type = TMap<TKey, TValue, TExtra...>;
+
+    inline static void write(BinWriter& mW, const Type& mX)
+    {
+        mW.putVarint(mX.size());
+        for(const auto& p : mX)
+        {
+            BinCodec<TKey>::write(mW, p.first);
+            BinCodec<TValue>::write(mW, p.second);
+        }
+    }
+    inline static void read(BinReader& mR, Type& mX)
+    {
+        auto n(mR.getSize(0));
+        mX.clear();
+
+        for(auto i(0u); i < n; ++i)
+        {
+            TKey k;
+            TValue v;
+            BinCodec<TKey>::read(mR, k);
+            BinCodec<TValue>::read(mR, v);
+            mX[std::move(k)] = std::move(v);
+        }
+    }
+    inline static void hash(BinHasher& mH)
+    {
+        mH.add("map");
+        BinCodec<TKey>::hash(mH);
+        BinCodec<TValue>::hash(mH);
+    }
+};
+
+// Types with macro-based converters are stored by running the converter
+// body with a binary archive in place of the `Val`
+template <typename T>
+struct BinCodec<T, std::enable_if_t<isBinCnvSimple<T>>>
+{
+    inline static void write(BinWriter& mW, const T& mX)
+    {
+        Cnv<T>::template impl<BinWriter&, const T&>(mW, mX);
+    }
+    inline static void read(BinReader& mR, T& mX)
+    {
+        Cnv<T>::template impl<BinReader&, T&>(mR, mX);
+    }
+    inline static void hash(BinHasher& mH)
+    {
+        SSVU_ASSERT_STATIC(std::is_default_constructible_v<T>,
+            "Binary snapshots require default-constructible types");
+
+        // Only the field types and keys are hashed, not their values.
+        // Visiting through `const T&` keeps the `Val` overloads of the
+        // converter functions from competing with the archive ones
+        const T dummy{};
+        Cnv<T>::template impl<BinHasher&, const T&>(mH, dummy);
+    }
+};
+} // namespace Impl
+} // namespace Json
+} // namespace ssvu
+
+#endif
@@ -290,6 +290,10 @@ private:
     {
         Obj obj;
 
+        // Pairs are sorted once, at the end: repeated keys keep the last
+        // value
+        auto pairs(obj.bulkBuilder());
+
         // Skip '{'
         ++idx;
 
@@ -297,7 +301,7 @@ private:
         if(isC('}')) goto end;
 
         // Reserve some memory
-        obj.reserve(10);
+        pairs.reserve(10);
 
         while(true)
         {
@@ -316,7 +320,7 @@ private:
             ++idx;
 
             // Read value
-            obj[std::move(key)] = parseVal();
+            pairs.add(std::move(key), parseVal());
 
             // Check for another key-value pair
             if(isC(','))
@@ -338,6 +342,7 @@ private:
         // Skip '}'
         ++idx;
 
+        pairs.commit();
         return Val{obj};
     }
 
@@ -18,7 +18,9 @@
 #include "SSVUtils/Json/Io/Writer.inl"
 #include "SSVUtils/Json/Val/Internal/CnvFuncs.hpp"
 #include "SSVUtils/Json/Val/Internal/CnvMacros.hpp"
+#include "SSVUtils/Json/Bin/Bin.hpp"
 #include "SSVUtils/Json/Stringifier/Stringifier.hpp"
+#include "SSVUtils/Json/Schema/Schema.hpp"
 
 #endif
 
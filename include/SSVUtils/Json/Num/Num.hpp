@@ -137,15 +137,21 @@ public:
     }
 
     // Equality/inequality
+    // The result does not depend on the order of the operands: numbers
+    // are compared as `Real` if either of them is a `Real`, and a negative
+    // `IntS` is never equal to an `IntU`. (Required by `Val::getHash`.)
     inline bool operator==(const Num& mN) const noexcept
     {
-        switch(repr)
-        {
-            case Repr::IntS: return getIntS() == mN.getIntS();
-            case Repr::IntU: return getIntU() == mN.getIntU();
-            case Repr::Real: return getReal() == mN.getReal();
-            default: SSVU_UNREACHABLE();
-        }
+        if(repr == Repr::Real || mN.repr == Repr::Real)
+            return getReal() == mN.getReal();
+
+        if(repr == mN.repr)
+            return repr == Repr::IntS ? h.get<IntS>() == mN.h.get<IntS>()
+                                      : h.get<IntU>() == mN.h.get<IntU>();
+
+        const auto& s(repr == Repr::IntS ? *this : mN);
+        const auto& u(repr == Repr::IntS ? mN : *this);
+        return s.h.get<IntS>() >= 0 && s.getIntU() == u.h.get<IntU>();
     }
     inline auto operator!=(const Num& mN) const noexcept
     {
@@ -0,0 +1,251 @@
+// Copyright (c) 2013-2015 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: http://opensource.org/licenses/AFL-3.0
+
+#ifndef SSVU_JSON_SCHEMA_INTERNAL_PROGRAM
+#define SSVU_JSON_SCHEMA_INTERNAL_PROGRAM
+
+#include "SSVUtils/Core/Core.hpp"
+#include "SSVUtils/Json/Common/Common.hpp"
+#include "SSVUtils/Json/Val/Val.hpp"
+
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace ssvu
+{
+namespace Json
+{
+namespace Impl
+{
+/// @typedef Bitmask of accepted `Val::Type` values.
+using SchemaTypeMask = unsigned int;
+
+/// @brief Returns the `SchemaTypeMask` bit corresponding to `mType`.
+inline constexpr SchemaTypeMask getSchemaTypeBit(Val::Type mType) noexcept
+{
+    return 1u << static_cast<unsigned int>(mType);
+}
+
+/// @brief Index value representing "no node".
+constexpr std::size_t schemaNullNode{std::numeric_limits<std::size_t>::max()};
+
+/// @brief Single compiled validation node.
+/// @details Nodes are stored in a flat array. Object properties of a node
+/// are stored contiguously in a separate array, sorted by key, so that they
+/// can be matched against the (sorted) `Obj` storage in a single merge pass.
+struct SchemaNode
+{
+    SchemaTypeMask types{0u};
+    bool integral{false}, closed{false};
+
+    Real minNum{std::numeric_limits<Real>::lowest()};
+    Real maxNum{std::numeric_limits<Real>::max()};
+
+    std::size_t minSize{0u};
+    std::size_t maxSize{std::numeric_limits<std::size_t>::max()};
+
+    std::size_t propBegin{0u}, propEnd{0u};
+    std::size_t itemNode{schemaNullNode};
+};
+
+/// @brief Compiled object property: key, requirement and node index.
+struct SchemaProp
+{
+    Key key;
+    bool required;
+    std::size_t node;
+};
+
+/// @brief Returns a human-readable representation of the types in
+/// `mTypes`.
+inline std::string getSchemaTypeMaskStr(SchemaTypeMask mTypes)
+{
+    constexpr const char* names[]{"obj", "arr", "str", "num", "bln", "nll"};
+
+    std::string result;
+    for(auto i(0u); i < sizeof(names) / sizeof(names[0]); ++i)
+    {
+        if((mTypes & (1u << i)) == 0) continue;
+        if(!result.empty()) result += '|';
+        result += names[i];
+    }
+
+    return result;
+}
+
+/// @brief Executes a compiled schema program on a `Val` tree.
+/// @tparam TStopOnFirst If true, execution stops at the first violation.
+/// @details Visits every `Val` once. Object keys are matched against the
+/// compiled properties with a sorted merge instead of per-key lookups. The
+/// current path is tracked as a stack of pointers and only turned into a
+/// string when a violation is reported.
+template <bool TStopOnFirst, typename TViolations>
+class SchemaRunner
+{
+private:
+    struct PathStep
+    {
+        const Key* key;
+        Idx idx;
+    };
+
+    const std::vector<SchemaNode>& nodes;
+    const std::vector<SchemaProp>& props;
+    TViolations& violations;
+    std::vector<PathStep> path;
+    bool failed{false};
+
+    inline std::string getPathStr() const
+    {
+        if(path.empty()) return "/";
+
+        std::string result;
+        for(const auto& s : path)
+        {
+            result += '/';
+            if(s.key == nullptr)
+            {
+                result += toStr(s.idx);
+                continue;
+            }
+
+            // Escape keys as JSON pointer reference tokens (RFC 6901)
+            for(auto c : *s.key)
+                if(c == '~')
+                    result += "~0";
+                else if(c == '/')
+                    result += "~1";
+                else
+                    result += c;
+        }
+
+        return result;
+    }
+
+    inline void report(std::string mWhat)
+    {
+        failed = true;
+        if(TStopOnFirst) return;
+        violations.emplace_back(getPathStr(), std::move(mWhat));
+    }
+
+    inline bool mustStop() const noexcept
+    {
+        return TStopOnFirst && failed;
+    }
+
+    inline void checkSize(const SchemaNode& mN, std::size_t mSize)
+    {
+        if(mSize < mN.minSize)
+            report("size " + toStr(mSize) + " is smaller than minimum " +
+                   toStr(mN.minSize));
+        else if(mSize > mN.maxSize)
+            report("size " + toStr(mSize) + " is greater than maximum " +
+                   toStr(mN.maxSize));
+    }
+
+    inline void runNum(const SchemaNode& mN, const Num& mNum)
+    {
+        if(mN.integral && mNum.getRepr() == Num::Repr::Real)
+        {
+            report("expected an integral number");
+            return;
+        }
+
+        auto x(mNum.as<Real>());
+        if(x < mN.minNum)
+            report(toStr(x) + " is smaller than minimum " + toStr(mN.minNum));
+        else if(x > mN.maxNum)
+            report(toStr(x) + " is greater than maximum " + toStr(mN.maxNum));
+    }
+
+    inline void runObj(const SchemaNode& mN, const Obj& mObj)
+    {
+        checkSize(mN, mObj.size());
+
+        auto itrV(std::begin(mObj)), endV(std::end(mObj));
+        auto iP(mN.propBegin);
+
+        while(!mustStop() && (itrV != endV || iP != mN.propEnd))
+        {
+            if(iP == mN.propEnd ||
+                (itrV != endV && itrV->first < props[iP].key))
+            {
+                // Key not described by the schema
+                if(mN.closed) report("unexpected key `" + itrV->first + "`");
+                ++itrV;
+            }
+            else if(itrV == endV || props[iP].key < itrV->first)
+            {
+                // Schema property not present in the object
+                if(props[iP].required)
+                    report("missing required key `" + props[iP].key + "`");
+                ++iP;
+            }
+            else
+            {
+                path.emplace_back(PathStep{&itrV->first, 0});
+                run(props[iP].node, itrV->second);
+                path.pop_back();
+
+                ++itrV;
+                ++iP;
+            }
+        }
+    }
+
+    inline void runArr(const SchemaNode& mN, const Arr& mArr)
+    {
+        checkSize(mN, mArr.size());
+        if(mN.itemNode == schemaNullNode) return;
+
+        for(auto i(0u); i < mArr.size() && !mustStop(); ++i)
+        {
+            path.emplace_back(PathStep{nullptr, i});
+            run(mN.itemNode, mArr[i]);
+            path.pop_back();
+        }
+    }
+
+public:
+    inline SchemaRunner(const std::vector<SchemaNode>& mNodes,
+        const std::vector<SchemaProp>& mProps, TViolations& mViolations)
+        : nodes(mNodes), props(mProps), violations(mViolations)
+    {
+    }
+
+    inline void run(std::size_t mNode, const Val& mV)
+    {
+        const auto& n(nodes[mNode]);
+        auto type(mV.getType());
+
+        if((n.types & getSchemaTypeBit(type)) == 0)
+        {
+            report("expected `" + getSchemaTypeMaskStr(n.types) + "`, got `" +
+                   getSchemaTypeMaskStr(getSchemaTypeBit(type)) + "`");
+            return;
+        }
+
+        switch(type)
+        {
+            case Val::Type::TObj: runObj(n, mV.as<Obj>()); break;
+            case Val::Type::TArr: runArr(n, mV.as<Arr>()); break;
+            case Val::Type::TStr: checkSize(n, mV.as<Str>().size()); break;
+            case Val::Type::TNum: runNum(n, mV.as<Num>()); break;
+            case Val::Type::TBln:
+            case Val::Type::TNll: break;
+        }
+    }
+
+    inline bool hasFailed() const noexcept
+    {
+        return failed;
+    }
+};
+} // namespace Impl
+} // namespace Json
+} // namespace ssvu
+
+#endif
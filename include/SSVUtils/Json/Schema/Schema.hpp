@@ -0,0 +1,265 @@
+// Copyright (c) 2013-2015 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: http://opensource.org/licenses/AFL-3.0
+
+#ifndef SSVU_JSON_SCHEMA
+#define SSVU_JSON_SCHEMA
+
+#include "SSVUtils/Core/Core.hpp"
+#include "SSVUtils/Json/Common/Common.hpp"
+#include "SSVUtils/Json/Val/Val.hpp"
+#include "SSVUtils/Json/Schema/Internal/Program.hpp"
+
+#include <string>
+#include <vector>
+
+namespace ssvu
+{
+namespace Json
+{
+class CompiledSchema;
+
+/// @brief Single schema violation found during validation.
+struct SchemaViolation
+{
+    /// @brief Path of the offending value, in JSON pointer notation.
+    std::string path;
+
+    /// @brief Description of the violation.
+    std::string what;
+
+    inline SchemaViolation(std::string mPath, std::string mWhat)
+        : path{std::move(mPath)}, what{std::move(mWhat)}
+    {
+    }
+};
+
+/// @typedef List of violations returned by `CompiledSchema::validate`.
+using SchemaViolations = std::vector<SchemaViolation>;
+
+/// @brief C++-declared description of the expected shape of a `Val`.
+/// @details Build a schema with the static factory functions and the
+/// chainable modifiers, then call `compile` once and reuse the resulting
+/// `CompiledSchema` for every validation.
+class Schema
+{
+    friend class CompiledSchema;
+
+private:
+    Impl::SchemaTypeMask types;
+    bool integral{false}, closed{false}, required{false};
+    Real minNum{std::numeric_limits<Real>::lowest()};
+    Real maxNum{std::numeric_limits<Real>::max()};
+    std::size_t minSize{0u};
+    std::size_t maxSize{std::numeric_limits<std::size_t>::max()};
+
+    /// @brief Key of this schema, if it describes an object property.
+    Key key;
+
+    /// @brief Object properties described by this schema.
+    std::vector<Schema> props;
+
+    /// @brief Array item schema. Either empty or a single element.
+    std::vector<Schema> item;
+
+    inline Schema(Impl::SchemaTypeMask mTypes) noexcept : types{mTypes}
+    {
+    }
+    inline static Schema mk(Val::Type mType) noexcept
+    {
+        return Schema{Impl::getSchemaTypeBit(mType)};
+    }
+
+    inline Schema& prop(Key mKey, Schema mS, bool mRequired)
+    {
+        SSVU_ASSERT(types & Impl::getSchemaTypeBit(Val::Type::TObj));
+        mS.key = std::move(mKey);
+        mS.required = mRequired;
+        props.emplace_back(std::move(mS));
+        return *this;
+    }
+
+public:
+    // Type factories
+    inline static Schema any() noexcept
+    {
+        return Schema{~Impl::SchemaTypeMask{0u}};
+    }
+    inline static Schema obj() noexcept
+    {
+        return mk(Val::Type::TObj);
+    }
+    inline static Schema arr() noexcept
+    {
+        return mk(Val::Type::TArr);
+    }
+    inline static Schema arr(Schema mItem)
+    {
+        auto result(arr());
+        result.items(std::move(mItem));
+        return result;
+    }
+    inline static Schema str() noexcept
+    {
+        return mk(Val::Type::TStr);
+    }
+    inline static Schema num() noexcept
+    {
+        return mk(Val::Type::TNum);
+    }
+    inline static Schema intg() noexcept
+    {
+        auto result(num());
+        result.integral = true;
+        return result;
+    }
+    inline static Schema bln() noexcept
+    {
+        return mk(Val::Type::TBln);
+    }
+    inline static Schema nll() noexcept
+    {
+        return mk(Val::Type::TNll);
+    }
+
+    /// @brief Additionally accepts `null` values.
+    inline Schema& orNll() noexcept
+    {
+        types |= Impl::getSchemaTypeBit(Val::Type::TNll);
+        return *this;
+    }
+
+    /// @brief Adds a required object property.
+    inline Schema& req(Key mKey, Schema mS)
+    {
+        return prop(std::move(mKey), std::move(mS), true);
+    }
+
+    /// @brief Adds an optional object property.
+    inline Schema& opt(Key mKey, Schema mS)
+    {
+        return prop(std::move(mKey), std::move(mS), false);
+    }
+
+    /// @brief Reports keys not described by `req`/`opt` as violations.
+    inline Schema& noExtraKeys() noexcept
+    {
+        closed = true;
+        return *this;
+    }
+
+    /// @brief Sets the schema every array item must satisfy.
+    inline Schema& items(Schema mS)
+    {
+        SSVU_ASSERT(types & Impl::getSchemaTypeBit(Val::Type::TArr));
+        item.clear();
+        item.emplace_back(std::move(mS));
+        return *this;
+    }
+
+    /// @brief Sets the inclusive numeric range.
+    inline Schema& range(Real mMin, Real mMax) noexcept
+    {
+        minNum = mMin;
+        maxNum = mMax;
+        return *this;
+    }
+
+    /// @brief Sets the inclusive size range. Applies to string lengths,
+    /// array sizes and object sizes.
+    inline Schema& size(std::size_t mMin, std::size_t mMax) noexcept
+    {
+        minSize = mMin;
+        maxSize = mMax;
+        return *this;
+    }
+
+    /// @brief Compiles the schema into a flat validation program.
+    CompiledSchema compile() const;
+};
+
+/// @brief Flat validation program compiled from a `Schema`.
+class CompiledSchema
+{
+    friend class Schema;
+
+private:
+    std::vector<Impl::SchemaNode> nodes;
+    std::vector<Impl::SchemaProp> props;
+
+    inline std::size_t compileNode(const Schema& mS)
+    {
+        auto idx(nodes.size());
+        nodes.emplace_back();
+
+        auto& n(nodes.back());
+        n.types = mS.types;
+        n.integral = mS.integral;
+        n.closed = mS.closed;
+        n.minNum = mS.minNum;
+        n.maxNum = mS.maxNum;
+        n.minSize = mS.minSize;
+        n.maxSize = mS.maxSize;
+
+        // Reserve a contiguous, key-sorted range for the properties before
+        // compiling them, as children append their own properties.
+        std::vector<const Schema*> sorted;
+        sorted.reserve(mS.props.size());
+        for(const auto& p : mS.props) sorted.emplace_back(&p);
+        sort(sorted, [](auto mA, auto mB) { return mA->key < mB->key; });
+
+        auto propBegin(props.size());
+        nodes[idx].propBegin = propBegin;
+        nodes[idx].propEnd = propBegin + sorted.size();
+
+        for(auto p : sorted)
+        {
+            SSVU_ASSERT(props.size() == propBegin ||
+                        props.back().key != p->key);
+            props.emplace_back(
+                Impl::SchemaProp{p->key, p->required, Impl::schemaNullNode});
+        }
+
+        for(auto i(0u); i < sorted.size(); ++i)
+            props[propBegin + i].node = compileNode(*sorted[i]);
+
+        if(!mS.item.empty())
+        {
+            auto itemNode(compileNode(mS.item.front()));
+            nodes[idx].itemNode = itemNode;
+        }
+
+        return idx;
+    }
+
+public:
+    /// @brief Validates `mV`, returning every violation found.
+    inline auto validate(const Val& mV) const
+    {
+        SchemaViolations result;
+        Impl::SchemaRunner<false, SchemaViolations> r{nodes, props, result};
+        r.run(0, mV);
+        return result;
+    }
+
+    /// @brief Returns true if `mV` satisfies the schema.
+    /// @details Stops at the first violation.
+    inline bool isValid(const Val& mV) const
+    {
+        SchemaViolations dummy;
+        Impl::SchemaRunner<true, SchemaViolations> r{nodes, props, dummy};
+        r.run(0, mV);
+        return !r.hasFailed();
+    }
+};
+
+inline CompiledSchema Schema::compile() const
+{
+    CompiledSchema result;
+    result.compileNode(*this);
+    return result;
+}
+} // namespace Json
+} // namespace ssvu
+
+#endif
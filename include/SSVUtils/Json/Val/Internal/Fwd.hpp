@@ -11,6 +11,9 @@ namespace ssvu
 {
 namespace Json
 {
+/// @brief Memory usage report of a `Val` tree.
+struct MemUsage;
+
 namespace Impl
 {
 // `Val` forward declaration.
@@ -43,6 +46,12 @@ struct TplCnvHelper;
 
 /// @brief Helper class for checking types to/from `std::tuple`.
 struct TplIsHelper;
+
+/// @brief Helper class for structural hashing.
+struct HashHelper;
+
+/// @brief Helper class for memory usage introspection.
+struct MemUsageHelper;
 } // namespace Impl
 } // namespace Json
 } // namespace ssvu
@@ -0,0 +1,99 @@
+// Copyright (c) 2013-2015 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: http://opensource.org/licenses/AFL-3.0
+
+#ifndef SSVU_JSON_VAL_INTERNAL_HASH
+#define SSVU_JSON_VAL_INTERNAL_HASH
+
+#include "SSVUtils/Json/Val/Val.hpp"
+
+#include <functional>
+
+namespace ssvu
+{
+namespace Json
+{
+namespace Impl
+{
+/// @brief Helper class for structural hashing of `Val` instances.
+struct HashHelper
+{
+    /// @brief Mixes `mX` into the hash `mSeed`.
+    inline static constexpr std::size_t combine(
+        std::size_t mSeed, std::size_t mX) noexcept
+    {
+        return mSeed ^ (mX + 0x9e3779b97f4a7c15ull + (mSeed << 6) +
+                           (mSeed >> 2));
+    }
+
+    /// @brief Hashes a number by its `Real` value, so that numbers
+    /// comparing equal with different representations share the hash.
+    inline static std::size_t hash(const Num& mN) noexcept
+    {
+        auto x(mN.as<Real>());
+        return std::hash<Real>{}(x == 0 ? Real(0) : x);
+    }
+
+    inline static std::size_t hash(const Obj& mObj) noexcept
+    {
+        auto result(mObj.size());
+        for(const auto& p : mObj)
+        {
+            result = combine(result, std::hash<Key>{}(p.first));
+            result = combine(result, p.second.getHash());
+        }
+        return result;
+    }
+
+    inline static std::size_t hash(const Arr& mArr) noexcept
+    {
+        auto result(mArr.size());
+        for(const auto& v : mArr) result = combine(result, v.getHash());
+        return result;
+    }
+
+    /// @brief Computes the structural hash of `mV`, without using or
+    /// updating its cache.
+    inline static std::size_t compute(const Val& mV) noexcept
+    {
+        auto seed(static_cast<std::size_t>(mV.getType()));
+
+        switch(mV.getType())
+        {
+            case Val::Type::TObj: return combine(seed, hash(mV.getObj()));
+            case Val::Type::TArr: return combine(seed, hash(mV.getArr()));
+            case Val::Type::TStr:
+                return combine(seed, std::hash<Str>{}(mV.getStr()));
+            case Val::Type::TNum: return combine(seed, hash(mV.getNum()));
+            case Val::Type::TBln: return combine(seed, mV.getBln());
+            case Val::Type::TNll: return seed;
+            default: SSVU_UNREACHABLE();
+        }
+    }
+};
+} // namespace Impl
+
+/// @brief Hasher for `Val`, usable in unordered containers.
+struct ValHasher
+{
+    inline std::size_t operator()(const Val& mV) const noexcept
+    {
+        return mV.getHash();
+    }
+};
+} // namespace Json
+} // namespace ssvu
+
+namespace std
+{
+template <>
+struct hash<ssvu::Json::Val>
+{
+    inline std::size_t operator()(const ssvu::Json::Val& mV) const noexcept
+    {
+        return mV.getHash();
+    }
+};
+} // namespace std
+
+#endif
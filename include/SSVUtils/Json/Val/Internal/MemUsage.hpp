@@ -0,0 +1,174 @@
+// Copyright (c) 2013-2015 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: http://opensource.org/licenses/AFL-3.0
+
+#ifndef SSVU_JSON_VAL_INTERNAL_MEMUSAGE
+#define SSVU_JSON_VAL_INTERNAL_MEMUSAGE
+
+#include "SSVUtils/Json/Val/Val.hpp"
+
+namespace ssvu
+{
+namespace Json
+{
+/// @brief Memory usage of all the values of a certain type in a `Val` tree.
+struct MemUsageEntry
+{
+    /// @brief Number of values.
+    std::size_t count{0u};
+
+    /// @brief Bytes actually required by the values.
+    std::size_t used{0u};
+
+    /// @brief Bytes allocated for the values, including unused capacity.
+    std::size_t reserved{0u};
+
+    /// @brief Returns the unused allocated bytes.
+    inline auto getSlack() const noexcept
+    {
+        return reserved - used;
+    }
+
+    inline auto& operator+=(const MemUsageEntry& mX) noexcept
+    {
+        count += mX.count;
+        used += mX.used;
+        reserved += mX.reserved;
+        return *this;
+    }
+};
+
+/// @brief Memory usage of a `Val` tree, broken down by value type.
+/// @details Every value is charged for its own `Val` slot and for the heap
+/// memory it owns. `Obj` values are also charged for their keys, and
+/// `Obj`/`Arr` values for the unused capacity of their storage.
+struct MemUsage
+{
+    MemUsageEntry obj, arr, str, num, other;
+
+    /// @brief Returns the sum of all the entries.
+    inline auto getTotal() const noexcept
+    {
+        auto result(obj);
+        result += arr;
+        result += str;
+        result += num;
+        result += other;
+        return result;
+    }
+};
+
+namespace Impl
+{
+/// @brief Helper class for memory usage introspection of `Val` trees.
+struct MemUsageHelper
+{
+    /// @brief Returns true if `mS`'s contents are stored on the heap.
+    inline static bool isOnHeap(const std::string& mS) noexcept
+    {
+        auto begin(reinterpret_cast<const char*>(&mS));
+        return mS.data() < begin || mS.data() >= begin + sizeof(mS);
+    }
+
+    inline static void addStrHeap(MemUsageEntry& mE, const std::string& mS)
+    {
+        if(!isOnHeap(mS)) return;
+        mE.used += mS.size() + 1;
+        mE.reserved += mS.capacity() + 1;
+    }
+
+    inline static void visit(MemUsage& mMU, const Val& mV)
+    {
+        auto& e(getEntry(mMU, mV.getType()));
+        ++e.count;
+        e.used += sizeof(Val);
+        e.reserved += sizeof(Val);
+
+        switch(mV.getType())
+        {
+            case Val::Type::TObj:
+            {
+                // Children are charged for their `Val` slots, the `Obj`
+                // for the rest of the item (the key) and for the slack.
+                const auto& data(mV.getObj().getData());
+                constexpr auto keySlot(sizeof(Obj::Item) - sizeof(Val));
+
+                e.used += data.size() * keySlot;
+                e.reserved +=
+                    data.capacity() * sizeof(Obj::Item) -
+                    data.size() * sizeof(Val);
+
+                for(const auto& p : data)
+                {
+                    addStrHeap(e, p.first);
+                    visit(mMU, p.second);
+                }
+
+                break;
+            }
+            case Val::Type::TArr:
+            {
+                const auto& arr(mV.getArr());
+                e.reserved += (arr.capacity() - arr.size()) * sizeof(Val);
+                for(const auto& v : arr) visit(mMU, v);
+                break;
+            }
+            case Val::Type::TStr: addStrHeap(e, mV.getStr()); break;
+            case Val::Type::TNum:
+            case Val::Type::TBln:
+            case Val::Type::TNll: break;
+        }
+    }
+
+    inline static MemUsageEntry& getEntry(
+        MemUsage& mMU, Val::Type mType) noexcept
+    {
+        switch(mType)
+        {
+            case Val::Type::TObj: return mMU.obj;
+            case Val::Type::TArr: return mMU.arr;
+            case Val::Type::TStr: return mMU.str;
+            case Val::Type::TNum: return mMU.num;
+            default: return mMU.other;
+        }
+    }
+
+    /// @brief Releases unused capacity in `mV` and in its children.
+    /// @details Accesses the storage directly, as the contents (and thus
+    /// the cached hashes) do not change.
+    inline static void shrinkToFit(Val& mV)
+    {
+        switch(mV.type)
+        {
+            case Val::Type::TObj:
+            {
+                auto& data(mV.h.template get<Obj>().getData());
+                data.shrink_to_fit();
+                for(auto& p : data)
+                {
+                    p.first.shrink_to_fit();
+                    shrinkToFit(p.second);
+                }
+                break;
+            }
+            case Val::Type::TArr:
+            {
+                auto& arr(mV.h.template get<Arr>());
+                arr.shrink_to_fit();
+                for(auto& v : arr) shrinkToFit(v);
+                break;
+            }
+            case Val::Type::TStr:
+                mV.h.template get<Str>().shrink_to_fit();
+                break;
+            case Val::Type::TNum:
+            case Val::Type::TBln:
+            case Val::Type::TNll: break;
+        }
+    }
+};
+} // namespace Impl
+} // namespace Json
+} // namespace ssvu
+
+#endif
@@ -36,6 +36,8 @@ class Val
     friend struct Impl::TplCnvHelper;
     friend struct Impl::TplIsHelper;
     friend struct Impl::CnvFuncHelper;
+    friend struct Impl::HashHelper;
+    friend struct Impl::MemUsageHelper;
 
 public:
     /// @brief Internal storage type.
@@ -66,6 +68,16 @@ private:
     /// @brief Checked union storage for `Val` fundamental types.
     Union<Obj, Arr, Str, Num, Bln> h;
 
+    /// @brief Cached structural hash of `Obj` and `Arr` values. `0` means
+    /// "not computed".
+    /// @details Reset whenever mutable access to the storage is requested.
+    mutable std::size_t hashCache{0u};
+
+    inline void invalidateHash() noexcept
+    {
+        hashCache = 0u;
+    }
+
     // Perfect-forwarding setters
     template <typename T>
     inline void setObj(T&& mX) noexcept(noexcept(Obj{FWD(mX)}))
@@ -108,6 +120,7 @@ private:
     inline mType& VRM_PP_CAT(get, mType)()& noexcept             \
     {                                                            \
         SSVU_ASSERT(is<mType>());                                \
+        invalidateHash();                                        \
         return mMember;                                          \
     }                                                            \
     inline const mType& VRM_PP_CAT(get, mType)() const& noexcept \
@@ -118,6 +131,7 @@ private:
     inline mType VRM_PP_CAT(get, mType)()&& noexcept             \
     {                                                            \
         SSVU_ASSERT(is<mType>());                                \
+        invalidateHash();                                        \
         return std::move(mMember);                               \
     }
 
@@ -144,6 +158,8 @@ private:
     /// appropriate destructor.
     inline void deinitCurrent()
     {
+        invalidateHash();
+
         switch(type)
         {
             case Type::TObj: h.deinit<Obj>(); break;
@@ -161,6 +177,9 @@ private:
     template <typename T>
     inline void init(T&& mV)
     {
+        // Mutable access to `mV` resets its cache: read it beforehand.
+        auto mVHash(mV.hashCache);
+
         switch(mV.type)
         {
             case Type::TObj:
@@ -176,6 +195,8 @@ private:
             case Type::TBln: setBln(mV.getBln()); break;
             case Type::TNll: setNll({}); break;
         }
+
+        hashCache = mVHash;
     }
 
     /// @brief Checks the stored type. Doesn't check number
@@ -334,10 +355,30 @@ public:
         return has(mIdx) ? operator[](mIdx).as<T>() : mDef;
     }
 
+    /// @brief Returns the structural hash of the `Val`.
+    /// @details The hash of `Obj` and `Arr` values (and of their nested
+    /// `Obj` and `Arr` values) is cached and reused until mutable access
+    /// to the storage is requested. References obtained through mutable
+    /// access before calling `getHash` must not be used to modify the value
+    /// afterwards. Not thread-safe, even on `const` instances.
+    std::size_t getHash() const noexcept;
+
+    /// @brief Returns the memory used by the `Val` tree, broken down by
+    /// value type.
+    MemUsage getMemUsage() const;
+
+    /// @brief Releases the unused capacity of the `Val` tree's internal
+    /// storage (vectors and strings).
+    void shrinkToFit();
+
     // Equality/inequality
+    // Short-circuits if both hashes are already cached and differ.
     inline bool SSVU_ATTRIBUTE(pure) operator==(const Val& mV) const noexcept
     {
         if(type != mV.type) return false;
+        if(this == &mV) return true;
+        if(hashCache != 0u && mV.hashCache != 0u && hashCache != mV.hashCache)
+            return false;
 
         switch(type)
         {
@@ -12,6 +12,8 @@
 #include "SSVUtils/Json/Val/Internal/CnvMacros.hpp"
 #include "SSVUtils/Json/Val/Internal/Chk.hpp"
 #include "SSVUtils/Json/Val/Internal/AsHelper.hpp"
+#include "SSVUtils/Json/Val/Internal/Hash.hpp"
+#include "SSVUtils/Json/Val/Internal/MemUsage.hpp"
 
 namespace ssvu
 {
@@ -47,6 +49,31 @@ inline auto Val::as() && -> decltype(Impl::AsHelper<T>::as(*this))
     return std::move(Impl::AsHelper<T>::as(*this));
 }
 
+inline std::size_t Val::getHash() const noexcept
+{
+    if(type != Type::TObj && type != Type::TArr)
+        return Impl::HashHelper::compute(*this);
+
+    if(hashCache == 0u)
+    {
+        auto result(Impl::HashHelper::compute(*this));
+        hashCache = result == 0u ? 1u : result;
+    }
+
+    return hashCache;
+}
+
+inline MemUsage Val::getMemUsage() const
+{
+    MemUsage result;
+    Impl::MemUsageHelper::visit(result, *this);
+    return result;
+}
+inline void Val::shrinkToFit()
+{
+    Impl::MemUsageHelper::shrinkToFit(*this);
+}
+
 template <typename TWS>
 inline void Val::writeToStream(std::ostream& mStream) const
 {
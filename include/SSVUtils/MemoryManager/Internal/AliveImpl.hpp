@@ -0,0 +1,192 @@
+// Copyright (c) 2013-2015 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: http://opensource.org/licenses/AFL-3.0
+
+#ifndef SSVU_MEMORYMANAGER_INTERNAL_ALIVEIMPL
+#define SSVU_MEMORYMANAGER_INTERNAL_ALIVEIMPL
+
+#include "SSVUtils/Core/Assert/Assert.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace ssvu
+{
+namespace Impl
+{
+/// @brief Alive/dead flags of `BaseManager` objects, stored in the
+/// objects' memory blocks. Requires a layout with a bool.
+/// @details Flags move together with the objects, so no bookkeeping is
+/// required when the manager reorders them.
+template <typename TBase, typename TLayout>
+struct AliveFlags
+{
+    inline void resize(std::size_t, std::size_t)
+    {
+    }
+    inline void clear(std::size_t) noexcept
+    {
+    }
+
+    inline void onCreate(std::size_t, TBase*) noexcept
+    {
+    }
+    inline void onSwap(std::size_t, TBase*, std::size_t, TBase*) noexcept
+    {
+    }
+    inline void onMove(std::size_t, TBase*) noexcept
+    {
+    }
+    inline void onCompact(std::size_t, std::size_t) noexcept
+    {
+    }
+
+    inline bool isAliveAt(std::size_t, const TBase* mBase) const noexcept
+    {
+        return isAlive(mBase);
+    }
+    inline void del(TBase& mBase) noexcept
+    {
+        TLayout::setBool(&mBase, false);
+    }
+    inline void delAt(std::size_t, TBase* mBase) noexcept
+    {
+        TLayout::setBool(mBase, false);
+    }
+
+    inline static bool isAlive(const TBase* mBase) noexcept
+    {
+        return TLayout::getBool(mBase);
+    }
+};
+
+/// @brief Alive/dead flags of `BaseManager` objects, stored in a bitset
+/// indexed by the position of the objects in the manager. Requires a layout
+/// with an index.
+/// @details Every object stores its own position, which is updated when
+/// the manager moves it. Checking the flags during a refresh only reads
+/// the bitset, not the objects. Flags are cleared atomically, so that
+/// different threads can delete different objects.
+template <typename TBase, typename TLayout>
+class AliveBitset
+{
+private:
+    using Word = std::uint64_t;
+    static constexpr std::size_t wordBits{64};
+
+    std::unique_ptr<std::atomic<Word>[]> words;
+
+    inline static auto getMask(std::size_t mI) noexcept
+    {
+        return Word(1) << (mI % wordBits);
+    }
+    inline auto& getWord(std::size_t mI) noexcept
+    {
+        return words[mI / wordBits];
+    }
+    inline const auto& getWord(std::size_t mI) const noexcept
+    {
+        return words[mI / wordBits];
+    }
+
+    inline void set(std::size_t mI, bool mX) noexcept
+    {
+        if(mX)
+            getWord(mI).fetch_or(getMask(mI), std::memory_order_relaxed);
+        else
+            getWord(mI).fetch_and(~getMask(mI), std::memory_order_relaxed);
+    }
+
+    inline static auto getWordCount(std::size_t mSize) noexcept
+    {
+        return (mSize + wordBits - 1) / wordBits;
+    }
+
+public:
+    /// @brief Resizes the bitset from `mCapacityOld` to `mCapacityNew`
+    /// flags. Flags past the new capacity are discarded.
+    inline void resize(std::size_t mCapacityOld, std::size_t mCapacityNew)
+    {
+        auto countOld(getWordCount(mCapacityOld));
+        auto countNew(getWordCount(mCapacityNew));
+        if(countNew == countOld) return;
+
+        auto newWords(std::make_unique<std::atomic<Word>[]>(countNew));
+        for(auto i(0u); i < countNew; ++i)
+            newWords[i].store(
+                i < countOld ? words[i].load(std::memory_order_relaxed) : 0,
+                std::memory_order_relaxed);
+
+        words = std::move(newWords);
+    }
+
+    /// @brief Clears the flags of the first `mSize` objects.
+    inline void clear(std::size_t mSize) noexcept
+    {
+        for(auto i(0u); i < getWordCount(mSize); ++i)
+            words[i].store(0, std::memory_order_relaxed);
+    }
+
+    inline void onCreate(std::size_t mI, TBase* mBase) noexcept
+    {
+        TLayout::setIdx(mBase, mI);
+        set(mI, true);
+    }
+
+    /// @brief Called after the objects at `mI0` and `mI1` are swapped.
+    inline void onSwap(std::size_t mI0, TBase* mBase0, std::size_t mI1,
+        TBase* mBase1) noexcept
+    {
+        // Flags still refer to the positions before the swap
+        auto alive0(isAliveAt(mI1, mBase0)), alive1(isAliveAt(mI0, mBase1));
+        set(mI0, alive0);
+        set(mI1, alive1);
+        TLayout::setIdx(mBase0, mI0);
+        TLayout::setIdx(mBase1, mI1);
+    }
+
+    /// @brief Called when an alive object is moved to `mI` by a parallel
+    /// compaction. Does not update the flags: see `onCompact`.
+    inline void onMove(std::size_t mI, TBase* mBase) noexcept
+    {
+        TLayout::setIdx(mBase, mI);
+    }
+
+    /// @brief Called after a parallel compaction, which moved `mAliveCount`
+    /// alive objects (out of `mSize`) to the beginning of the manager.
+    inline void onCompact(std::size_t mAliveCount, std::size_t mSize) noexcept
+    {
+        for(auto i(0u); i < getWordCount(mSize); ++i)
+        {
+            auto begin(i * wordBits);
+            Word w{0};
+
+            if(mAliveCount >= begin + wordBits)
+                w = ~Word(0);
+            else if(mAliveCount > begin)
+                w = (Word(1) << (mAliveCount - begin)) - 1;
+
+            words[i].store(w, std::memory_order_relaxed);
+        }
+    }
+
+    inline bool isAliveAt(std::size_t mI, const TBase*) const noexcept
+    {
+        return (getWord(mI).load(std::memory_order_relaxed) & getMask(mI)) !=
+               0;
+    }
+    inline void del(TBase& mBase) noexcept
+    {
+        set(TLayout::getIdx(&mBase), false);
+    }
+    inline void delAt(std::size_t mI, TBase*) noexcept
+    {
+        set(mI, false);
+    }
+};
+} // namespace Impl
+} // namespace ssvu
+
+#endif
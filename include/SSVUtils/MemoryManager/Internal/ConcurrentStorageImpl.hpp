@@ -0,0 +1,549 @@
+// Copyright (c) 2013-2015 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: http://opensource.org/licenses/AFL-3.0
+
+#ifndef SSVU_MEMORYMANAGER_INTERNAL_CONCURRENTSTORAGEIMPL
+#define SSVU_MEMORYMANAGER_INTERNAL_CONCURRENTSTORAGEIMPL
+
+#include "SSVUtils/Core/Common/Casts.hpp"
+#include "SSVUtils/Core/Common/LikelyUnlikely.hpp"
+#include "SSVUtils/MemoryManager/Internal/StorageImpl.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace ssvu
+{
+namespace Impl
+{
+/// @brief Tuning parameters of `ConcurrentChunk`.
+struct ConcurrentChunkPolicy
+{
+    /// @brief Number of objects moved at once between a thread cache and
+    /// the shared pool.
+    static constexpr std::size_t batchSize{32};
+
+    /// @brief Number of per-thread caches of every chunk. Threads beyond
+    /// this amount (running at the same time) use a locked fallback path.
+    static constexpr std::size_t maxThreadCaches{64};
+};
+
+/// @brief Assigns small integer ids to the running threads.
+/// @details Ids of exited threads are reused, so that the ids of the
+/// running threads stay small.
+class ThreadSlots
+{
+private:
+    std::mutex mtx;
+    std::vector<std::size_t> freeIds;
+    std::size_t nextId{0};
+
+public:
+    inline static auto& get() noexcept
+    {
+        static ThreadSlots instance;
+        return instance;
+    }
+
+    inline std::size_t acquire()
+    {
+        std::lock_guard<std::mutex> lock{mtx};
+        if(freeIds.empty()) return nextId++;
+
+        auto result(freeIds.back());
+        freeIds.pop_back();
+        return result;
+    }
+
+    inline void release(std::size_t mId)
+    {
+        std::lock_guard<std::mutex> lock{mtx};
+        freeIds.emplace_back(mId);
+    }
+};
+
+/// @brief Returns the id of the current thread. See `ThreadSlots`.
+inline std::size_t getThreadSlot()
+{
+    thread_local struct Holder
+    {
+        std::size_t id{ThreadSlots::get().acquire()};
+        inline ~Holder()
+        {
+            ThreadSlots::get().release(id);
+        }
+    } holder;
+
+    return holder.id;
+}
+
+/// @brief Free object in a `ConcurrentChunk`, linked to the next free
+/// object of its batch (or thread cache).
+struct ConcurrentFreeNode
+{
+    ConcurrentFreeNode* next;
+};
+
+/// @brief Lock-free pool of batches of free objects, shared by the threads
+/// of a `ConcurrentChunk`.
+/// @details Batches are described by descriptors kept outside of the
+/// objects' memory, and linked in two lock-free (Treiber) stacks: the
+/// stack of full batches and the stack of unused descriptors. Stack tops
+/// pack a 32-bit descriptor index together with a 32-bit modification tag,
+/// which is incremented by every push and pop, to protect against ABA.
+/// Pointers are never packed, so no assumption is made on the width of
+/// addresses. Descriptors are only freed with the pool, and their links
+/// are atomic: a thread that reads the link of a concurrently popped
+/// descriptor gets a stale value, which is discarded as the tag makes the
+/// compare-and-swap fail.
+class ConcurrentBatchPool
+{
+private:
+    using NodeType = ConcurrentFreeNode;
+
+    struct Batch
+    {
+        // 1-based index of the next descriptor in its stack, or 0
+        std::atomic<std::uint32_t> next{0};
+        NodeType* head{nullptr};
+    };
+
+    // Segment `s` holds `firstSegmentSize << s` descriptors, so that
+    // descriptors never move and indices map to them without locking
+    static constexpr std::size_t firstSegmentSize{64};
+    static constexpr std::size_t segmentCount{26};
+
+    std::array<std::atomic<Batch*>, segmentCount> segments{};
+    std::atomic<std::uint64_t> full{0}, unused{0};
+
+    // Only accessed by `reserve`, which is externally synchronized
+    std::size_t usedSegments{0}, capacity{0};
+
+    inline auto& get(std::uint32_t mIdx) const noexcept
+    {
+        auto k(std::size_t(mIdx - 1) / firstSegmentSize + 1);
+        std::size_t s{0};
+        while(k >>= 1) ++s;
+
+        auto first(firstSegmentSize * ((std::size_t(1) << s) - 1));
+        return segments[s].load(std::memory_order_acquire)[mIdx - 1 - first];
+    }
+
+    inline static std::uint32_t getIdx(std::uint64_t mX) noexcept
+    {
+        return std::uint32_t(mX);
+    }
+    inline static std::uint64_t pack(
+        std::uint32_t mIdx, std::uint64_t mOld) noexcept
+    {
+        return ((mOld >> 32) + 1) << 32 | mIdx;
+    }
+
+    inline void push(
+        std::atomic<std::uint64_t>& mTop, std::uint32_t mIdx) noexcept
+    {
+        auto& b(get(mIdx));
+        auto old(mTop.load(std::memory_order_relaxed));
+        do
+        {
+            b.next.store(getIdx(old), std::memory_order_relaxed);
+        } while(!mTop.compare_exchange_weak(old, pack(mIdx, old),
+            std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    inline std::uint32_t pop(std::atomic<std::uint64_t>& mTop) noexcept
+    {
+        auto old(mTop.load(std::memory_order_acquire));
+        while(true)
+        {
+            auto idx(getIdx(old));
+            if(idx == 0) return 0;
+
+            auto next(get(idx).next.load(std::memory_order_relaxed));
+            if(mTop.compare_exchange_weak(old, pack(next, old),
+                   std::memory_order_acquire, std::memory_order_acquire))
+                return idx;
+        }
+    }
+
+public:
+    inline ConcurrentBatchPool() = default;
+
+    inline ConcurrentBatchPool(const ConcurrentBatchPool&) = delete;
+    inline auto& operator=(const ConcurrentBatchPool&) = delete;
+
+    inline ~ConcurrentBatchPool() noexcept
+    {
+        for(auto& s : segments) delete[] s.load(std::memory_order_relaxed);
+    }
+
+    /// @brief Makes sure that at least `mCount` batches can be stored.
+    /// @details Not thread-safe with respect to other `reserve` calls.
+    inline void reserve(std::size_t mCount)
+    {
+        while(capacity < mCount && usedSegments < segmentCount)
+        {
+            auto size(firstSegmentSize << usedSegments);
+            segments[usedSegments].store(
+                new Batch[size], std::memory_order_release);
+
+            for(auto i(0u); i < size; ++i)
+                push(unused, std::uint32_t(capacity + i + 1));
+
+            ++usedSegments;
+            capacity += size;
+        }
+    }
+
+    /// @brief Pushes the batch starting with `mHead`. Returns `false`,
+    /// without pushing, if all the descriptors are in use.
+    inline bool push(NodeType* mHead) noexcept
+    {
+        auto idx(pop(unused));
+        if(idx == 0) return false;
+
+        get(idx).head = mHead;
+        push(full, idx);
+        return true;
+    }
+
+    /// @brief Pops a batch. Returns `nullptr` if the pool is empty.
+    inline NodeType* pop() noexcept
+    {
+        auto idx(pop(full));
+        if(idx == 0) return nullptr;
+
+        auto result(get(idx).head);
+        push(unused, idx);
+        return result;
+    }
+};
+
+/// @brief Thread-safe memory "chunk" storage structure for a certain
+/// object type.
+/// @details Every thread creates and recycles objects through its own
+/// cache, without synchronization. When a cache grows too big, a batch of
+/// objects is moved to a lock-free pool shared by all threads; empty
+/// caches take whole batches from it. Objects can be recycled by a thread
+/// different from the one that created them: the memory goes to the
+/// recycling thread's cache. New memory is carved out of slabs under a
+/// lock, a batch at a time.
+template <typename TBase, template <typename> class TLHelper>
+class ConcurrentChunk
+{
+private:
+    using LHelperType = TLHelper<TBase>;
+    using NodeType = ConcurrentFreeNode;
+    using Policy = ConcurrentChunkPolicy;
+
+    struct alignas(64) ThreadCache
+    {
+        NodeType* head{nullptr};
+        std::size_t count{0};
+    };
+
+    std::array<ThreadCache, Policy::maxThreadCaches> caches;
+    ConcurrentBatchPool shared;
+
+    // Number of batches carved out of the slabs, protected by `mtx`
+    std::size_t batchCount{0};
+
+    // Protects `slabs` and `overflow`
+    std::mutex mtx;
+    SlabAllocator slabs;
+    PtrChain<TBase, TLHelper> overflow;
+
+    template <typename T>
+    inline char* allocateBlock()
+    {
+        return slabs.allocate(LHelperType::template getBlockSize<T>(),
+            LHelperType::template getItemAlign<T>(), LHelperType::headerSize);
+    }
+
+    template <typename T>
+    inline void refill(ThreadCache& mCache)
+    {
+        if(auto batch = shared.pop())
+        {
+            mCache.head = batch;
+            mCache.count = Policy::batchSize;
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock{mtx};
+
+        // Every batch of objects can be stored in the shared pool
+        shared.reserve(batchCount + 1);
+        ++batchCount;
+
+        for(auto i(0u); i < Policy::batchSize; ++i)
+        {
+            auto node(reinterpret_cast<NodeType*>(
+                overflow.isEmpty() ? allocateBlock<T>()
+                                   : overflow.template pop<char>()));
+            node->next = mCache.head;
+            mCache.head = node;
+        }
+        mCache.count = Policy::batchSize;
+    }
+
+    inline void flushBatch(ThreadCache& mCache) noexcept
+    {
+        auto batch(mCache.head);
+        auto tail(batch);
+        for(auto i(1u); i < Policy::batchSize; ++i) tail = tail->next;
+
+        // Objects created through the locked fallback path have no
+        // descriptors: if none is left, the objects stay in the cache
+        auto rest(tail->next);
+        tail->next = nullptr;
+        if(SSVU_UNLIKELY(!shared.push(batch)))
+        {
+            tail->next = rest;
+            return;
+        }
+
+        mCache.head = rest;
+        mCache.count -= Policy::batchSize;
+    }
+
+    template <typename T>
+    inline char* allocate()
+    {
+        auto id(getThreadSlot());
+
+        if(SSVU_UNLIKELY(id >= Policy::maxThreadCaches))
+        {
+            std::lock_guard<std::mutex> lock{mtx};
+            return overflow.isEmpty() ? allocateBlock<T>()
+                                      : overflow.template pop<char>();
+        }
+
+        auto& cache(caches[id]);
+        if(SSVU_UNLIKELY(cache.head == nullptr)) refill<T>(cache);
+
+        auto result(cache.head);
+        cache.head = result->next;
+        --cache.count;
+        return reinterpret_cast<char*>(result);
+    }
+
+    // Constructs a `T` in newly allocated memory. If the constructor
+    // throws, the memory is recycled before rethrowing
+    template <typename T, typename... TArgs>
+    inline T* allocateConstruct(TArgs&&... mArgs)
+    {
+        auto block(allocate<T>());
+        try
+        {
+            return LHelperType::template construct<T>(block, FWD(mArgs)...);
+        }
+        catch(...)
+        {
+            reclaimBlock(block);
+            throw;
+        }
+    }
+
+    inline void reclaimBlock(char* mBlock) noexcept
+    {
+        auto id(getThreadSlot());
+
+        if(SSVU_UNLIKELY(id >= Policy::maxThreadCaches))
+        {
+            std::lock_guard<std::mutex> lock{mtx};
+            overflow.push(mBlock);
+            return;
+        }
+
+        auto& cache(caches[id]);
+        auto node(reinterpret_cast<NodeType*>(mBlock));
+        node->next = cache.head;
+        cache.head = node;
+
+        if(++cache.count >= Policy::batchSize * 2) flushBatch(cache);
+    }
+
+public:
+    inline ConcurrentChunk() noexcept
+    {
+        SSVU_ASSERT_STATIC(
+            LHelperType::template getBlockSize<TBase>() >= sizeof(NodeType),
+            "sizeof(TBase) must be >= sizeof(char*)");
+    }
+
+    inline ConcurrentChunk(const ConcurrentChunk&) = delete;
+    inline ConcurrentChunk(ConcurrentChunk&&) = delete;
+
+    inline auto& operator=(const ConcurrentChunk&) = delete;
+    inline auto& operator=(ConcurrentChunk&&) = delete;
+
+    /// @brief Sets the minimum size and alignment of the object slots. See
+    /// `SlabAllocator::setMinSlot`.
+    inline void setMinSlot(std::size_t mSize, std::size_t mAlign) noexcept
+    {
+        slabs.setMinSlot(mSize, mAlign);
+    }
+
+    /// @brief Creates and constructs a `T` instance.
+    /// @details Uses the current thread's cache if possible.
+    template <typename T, typename... TArgs>
+    inline T* create(TArgs&&... mArgs)
+    {
+        return allocateConstruct<T>(FWD(mArgs)...);
+    }
+
+    /// @brief Creates `mCount` `T` instances, constructed with `mArgs`,
+    /// and calls `mF(ptr)` for each of them.
+    template <typename T, typename TF, typename... TArgs>
+    inline void createN(
+        std::size_t mCount, const TF& mF, const TArgs&... mArgs)
+    {
+        for(auto i(0u); i < mCount; ++i)
+            mF(allocateConstruct<T>(mArgs...));
+    }
+
+    /// @brief Destroys a pointer that is in use. Can be called from any
+    /// thread: the memory is recycled in the current thread's cache.
+    inline void recycle(TBase* mBase) noexcept(
+        noexcept(LHelperType::destroy(mBase)))
+    {
+        LHelperType::destroy(mBase);
+        reclaim(mBase);
+    }
+
+    /// @brief Recycles the memory of a pointer whose contents were already
+    /// destroyed. Can be called from any thread.
+    inline void reclaim(TBase* mBase) noexcept
+    {
+        reclaimBlock(LHelperType::getBlock(mBase));
+    }
+
+    /// @brief Returns the memory of recycled objects to the system, until
+    /// at most `mMaxFree` recycled objects are left. Returns the number of
+    /// released bytes. See `Chunk::trim`.
+    /// @details Not thread-safe: must not be called while other threads
+    /// create or recycle objects of the chunk. Recycled objects are moved
+    /// out of the thread caches and the shared pool.
+    inline std::size_t trim(std::size_t mMaxFree) noexcept
+    {
+        std::lock_guard<std::mutex> lock{mtx};
+
+        auto drain([this](NodeType* mNode)
+            {
+                while(mNode != nullptr)
+                {
+                    auto next(mNode->next);
+                    overflow.push(mNode);
+                    mNode = next;
+                }
+            });
+
+        for(auto& c : caches)
+        {
+            drain(c.head);
+            c.head = nullptr;
+            c.count = 0;
+        }
+
+        while(auto batch = shared.pop()) drain(batch);
+
+        // Thread caches are refilled from the remaining objects
+        return slabs.trim(overflow, mMaxFree);
+    }
+};
+
+/// @brief Thread-safe storage data structure for multiple types
+/// (run-time) - uses an array of `ConcurrentChunk` objects, one per size
+/// class. See `PolyStorage`.
+/// @details Chunks are created lazily, as they are big: lookups are a
+/// single atomic load. Types that are too big or over-aligned use a map of
+/// `ConcurrentChunk` objects, protected by a shared lock.
+template <typename TBase, template <typename> class TLHelper>
+class ConcurrentPolyStorage
+{
+public:
+    using ChunkType = ConcurrentChunk<TBase, TLHelper>;
+
+private:
+    using LHelperType = TLHelper<TBase>;
+
+    std::array<std::atomic<ChunkType*>, sizeClassCount> chunks{};
+
+    std::shared_mutex mtx;
+    std::unordered_map<std::size_t, ChunkType> bigChunks;
+
+    inline auto& createChunk(std::size_t mIdx)
+    {
+        auto chunk(new ChunkType);
+        chunk->setMinSlot(getSizeClassSize(mIdx), sizeClassGranularity);
+
+        ChunkType* expected{nullptr};
+        if(chunks[mIdx].compare_exchange_strong(expected, chunk,
+               std::memory_order_acq_rel, std::memory_order_acquire))
+            return *chunk;
+
+        // Another thread created the chunk first
+        delete chunk;
+        return *expected;
+    }
+
+    inline auto& getBigChunk(std::size_t mKey)
+    {
+        {
+            std::shared_lock<std::shared_mutex> lock{mtx};
+            auto itr(bigChunks.find(mKey));
+            if(itr != std::end(bigChunks)) return itr->second;
+        }
+
+        std::unique_lock<std::shared_mutex> lock{mtx};
+        return bigChunks[mKey];
+    }
+
+public:
+    inline ConcurrentPolyStorage() = default;
+
+    inline ConcurrentPolyStorage(const ConcurrentPolyStorage&) = delete;
+    inline auto& operator=(const ConcurrentPolyStorage&) = delete;
+
+    inline ~ConcurrentPolyStorage() noexcept
+    {
+        for(auto& c : chunks) delete c.load(std::memory_order_relaxed);
+    }
+
+    /// @brief Calls `mF(chunk)` for every created chunk.
+    template <typename TF>
+    inline void forEachChunk(const TF& mF)
+    {
+        for(auto& c : chunks)
+            if(auto chunk = c.load(std::memory_order_acquire)) mF(*chunk);
+
+        std::shared_lock<std::shared_mutex> lock{mtx};
+        for(auto& p : bigChunks) mF(p.second);
+    }
+
+    template <typename T>
+    inline auto& getChunk()
+    {
+        constexpr auto size(LHelperType::template getBlockSize<T>());
+        constexpr auto align(LHelperType::template getItemAlign<T>());
+
+        if constexpr(hasSizeClass(size, align))
+        {
+            constexpr auto idx(getSizeClassIdx(size));
+            auto chunk(chunks[idx].load(std::memory_order_acquire));
+            return SSVU_LIKELY(chunk != nullptr) ? *chunk : createChunk(idx);
+        }
+        else
+            return getBigChunk(getBigChunkKey(size, align));
+    }
+};
+} // namespace Impl
+} // namespace ssvu
+
+#endif
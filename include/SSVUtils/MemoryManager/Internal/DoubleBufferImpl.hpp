@@ -0,0 +1,330 @@
+// Copyright (c) 2013-2015 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: http://opensource.org/licenses/AFL-3.0
+
+#ifndef SSVU_MEMORYMANAGER_INTERNAL_DOUBLEBUFFERIMPL
+#define SSVU_MEMORYMANAGER_INTERNAL_DOUBLEBUFFERIMPL
+
+#include "SSVUtils/Core/Assert/Assert.hpp"
+#include "SSVUtils/Core/Common/Aliases.hpp"
+#include "SSVUtils/Core/Common/Casts.hpp"
+#include "SSVUtils/MemoryManager/Internal/LayoutImpl.hpp"
+#include "SSVUtils/MemoryManager/Internal/StorageImpl.hpp"
+#include "SSVUtils/MemoryManager/Internal/RecyclerImpl.hpp"
+#include "SSVUtils/MemoryManager/Internal/ManagerImpl.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <limits>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace ssvu
+{
+namespace Impl
+{
+/// @brief Memory manager for a single type, with a read-only snapshot of
+/// its objects that can be read by other threads.
+/// @tparam T Type of manager objects. Must be copyable, and not final.
+/// @details A single writer thread creates, modifies, deletes and
+/// refreshes objects like in a `MonoManager`. `publish()`, called at frame
+/// boundaries, makes a copy of the objects available to reader threads,
+/// which acquire it with `acquire()` and iterate it without locks while
+/// the writer keeps mutating the objects.
+/// Two snapshot buffers are used: readers use the last published one, the
+/// writer updates the other one. Updates are incremental: only objects
+/// that were created, deleted or marked as modified since the buffer was
+/// last updated are copied. Modified objects must be marked with
+/// `modify()` or `markChanged()`.
+template <typename T>
+class DoubleBufferManagerImpl
+{
+private:
+    static constexpr std::size_t npos{std::numeric_limits<std::size_t>::max()};
+
+    class Entry;
+    struct State;
+
+    /// @brief Snapshot buffer: copies of the objects, and the entries they
+    /// were copied from.
+    struct Buffer
+    {
+        std::vector<T> values;
+        std::vector<Entry*> owners;
+
+        // Changes not yet applied to this buffer. Entries are destroyed by
+        // noexcept refreshes: `removed` always has room for every owner
+        std::vector<Entry*> changed;
+        std::vector<std::size_t> removed;
+
+        std::atomic<std::size_t> readers{0};
+    };
+
+    /// @brief Bookkeeping shared by the entries.
+    struct State
+    {
+        Buffer buffers[2];
+        std::atomic<std::size_t> front{0};
+    };
+
+    /// @brief Managed object: the user object, plus its position in
+    /// every snapshot buffer.
+    class Entry : public T
+    {
+        friend class DoubleBufferManagerImpl;
+
+    private:
+        State* state;
+        std::size_t idx[2]{npos, npos};
+        std::size_t changedPos[2]{npos, npos};
+
+    public:
+        template <typename... TArgs>
+        inline Entry(State& mState, TArgs&&... mArgs)
+            : T(FWD(mArgs)...), state{&mState}
+        {
+        }
+
+        inline ~Entry()
+        {
+            for(auto b(0u); b < 2; ++b)
+            {
+                auto& buf(state->buffers[b]);
+                if(changedPos[b] != npos) buf.changed[changedPos[b]] = nullptr;
+                if(idx[b] != npos) buf.removed.emplace_back(idx[b]);
+            }
+        }
+    };
+
+    using ManagerType = BaseManager<Entry,
+        MonoRecyclerImpl<Entry, LayoutImpl::LHelperBool,
+            MonoStorage<Entry, LayoutImpl::LHelperBool>>>;
+
+    // Declared first: destroyed after the manager, whose entries access it
+    State state;
+    ManagerType manager;
+
+    inline static auto& getEntry(const T& mX) noexcept
+    {
+        return const_cast<Entry&>(castUp<Entry>(mX));
+    }
+
+    inline void markChangedImpl(Entry& mE)
+    {
+        for(auto b(0u); b < 2; ++b)
+        {
+            if(mE.changedPos[b] != npos) continue;
+
+            auto& changed(state.buffers[b].changed);
+            mE.changedPos[b] = changed.size();
+            changed.emplace_back(&mE);
+        }
+    }
+
+    /// @brief Applies the pending changes to the buffer with index `mB`.
+    inline void update(std::size_t mB)
+    {
+        auto& buf(state.buffers[mB]);
+
+        // Removing from the back keeps the pending indices valid: the last
+        // object, moved in place of the removed one, is never pending
+        std::sort(std::begin(buf.removed), std::end(buf.removed),
+            std::greater<std::size_t>{});
+
+        for(auto i : buf.removed)
+        {
+            auto last(buf.values.size() - 1);
+            if(i != last)
+            {
+                buf.values[i] = std::move(buf.values[last]);
+                buf.owners[i] = buf.owners[last];
+                buf.owners[i]->idx[mB] = i;
+            }
+
+            buf.values.pop_back();
+            buf.owners.pop_back();
+        }
+
+        for(auto e : buf.changed)
+        {
+            if(e == nullptr) continue;
+            e->changedPos[mB] = npos;
+
+            const T& value(*e);
+            if(e->idx[mB] != npos)
+            {
+                buf.values[e->idx[mB]] = value;
+                continue;
+            }
+
+            auto required(buf.owners.size() + 1);
+            if(buf.removed.capacity() < required)
+                buf.removed.reserve(
+                    std::max(required, buf.removed.capacity() * 2));
+
+            buf.values.emplace_back(value);
+            buf.owners.emplace_back(e);
+            e->idx[mB] = buf.values.size() - 1;
+        }
+
+        buf.removed.clear();
+        buf.changed.clear();
+    }
+
+public:
+    /// @brief Read-only view of a published snapshot. Keeps the snapshot
+    /// alive until destroyed.
+    /// @details Snapshots must be released promptly (e.g. within a
+    /// frame): the writer waits for the readers of a buffer before
+    /// updating it.
+    class Snapshot
+    {
+    private:
+        const Buffer* buffer{nullptr};
+
+    public:
+        inline Snapshot(const Buffer& mBuffer) noexcept : buffer{&mBuffer}
+        {
+        }
+
+        inline Snapshot(const Snapshot&) = delete;
+        inline Snapshot(Snapshot&& mS) noexcept : buffer{mS.buffer}
+        {
+            mS.buffer = nullptr;
+        }
+
+        inline auto& operator=(const Snapshot&) = delete;
+        inline auto& operator=(Snapshot&&) = delete;
+
+        inline ~Snapshot() noexcept
+        {
+            if(buffer != nullptr)
+                const_cast<Buffer*>(buffer)->readers.fetch_sub(
+                    1, std::memory_order_release);
+        }
+
+        inline const T& operator[](std::size_t mI) const noexcept
+        {
+            return buffer->values[mI];
+        }
+        inline auto size() const noexcept
+        {
+            return buffer->values.size();
+        }
+        inline auto begin() const noexcept
+        {
+            return std::cbegin(buffer->values);
+        }
+        inline auto end() const noexcept
+        {
+            return std::cend(buffer->values);
+        }
+    };
+
+    inline DoubleBufferManagerImpl()
+    {
+        SSVU_ASSERT_STATIC(std::is_copy_assignable_v<T> &&
+                               std::is_copy_constructible_v<T>,
+            "DoubleBufferManager objects must be copyable");
+    }
+
+    inline DoubleBufferManagerImpl(const DoubleBufferManagerImpl&) = delete;
+    inline auto& operator=(const DoubleBufferManagerImpl&) = delete;
+
+    // Writer interface
+
+    /// @brief Creates a `T` instance. It will be part of the next published
+    /// snapshot.
+    template <typename... TArgs>
+    inline T& create(TArgs&&... mArgs)
+    {
+        auto& e(manager.create(state, FWD(mArgs)...));
+        markChangedImpl(e);
+        return e;
+    }
+
+    /// @brief Marks `mX` as modified, so that it is copied to the next
+    /// published snapshot.
+    inline void markChanged(const T& mX)
+    {
+        markChangedImpl(getEntry(mX));
+    }
+
+    /// @brief Marks `mX` as modified and returns it.
+    inline T& modify(const T& mX)
+    {
+        auto& e(getEntry(mX));
+        markChangedImpl(e);
+        return e;
+    }
+
+    inline void del(T& mX) noexcept
+    {
+        manager.del(getEntry(mX));
+    }
+
+    inline void refresh()
+    {
+        manager.refresh();
+    }
+
+    inline void clear() noexcept
+    {
+        manager.clear();
+    }
+
+    /// @brief Calls `mFn(obj)` for every object of the writer side.
+    template <typename TF>
+    inline void forEach(const TF& mFn)
+    {
+        for(auto& p : manager) mFn(static_cast<T&>(*p));
+    }
+
+    inline auto size() const noexcept
+    {
+        return manager.size();
+    }
+
+    /// @brief Refreshes the manager, then publishes a snapshot of its
+    /// objects. Waits until no reader uses the buffer that is updated.
+    inline void publish()
+    {
+        manager.refresh();
+
+        auto back(1 - state.front.load(std::memory_order_relaxed));
+        auto& buf(state.buffers[back]);
+
+        while(buf.readers.load(std::memory_order_seq_cst) != 0)
+            std::this_thread::yield();
+
+        update(back);
+        state.front.store(back, std::memory_order_seq_cst);
+    }
+
+    // Reader interface
+
+    /// @brief Returns the last published snapshot. Can be called from any
+    /// thread.
+    inline Snapshot acquire() const noexcept
+    {
+        auto& s(const_cast<State&>(state));
+        while(true)
+        {
+            auto f(s.front.load(std::memory_order_seq_cst));
+            auto& buf(s.buffers[f]);
+            buf.readers.fetch_add(1, std::memory_order_seq_cst);
+
+            // The buffer may have been swapped out in the meantime
+            if(s.front.load(std::memory_order_seq_cst) == f)
+                return Snapshot{buf};
+
+            buf.readers.fetch_sub(1, std::memory_order_release);
+        }
+    }
+};
+} // namespace Impl
+} // namespace ssvu
+
+#endif
@@ -0,0 +1,146 @@
+// Copyright (c) 2013-2015 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: http://opensource.org/licenses/AFL-3.0
+
+#ifndef SSVU_MEMORYMANAGER_INTERNAL_EPOCHIMPL
+#define SSVU_MEMORYMANAGER_INTERNAL_EPOCHIMPL
+
+#include "SSVUtils/Core/Assert/Assert.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+
+namespace ssvu
+{
+class MMEpochDomain;
+
+/// @brief Pin of an epoch of a `MMEpochDomain`, released on destruction.
+/// @details While the guard is alive, objects deleted from managers that
+/// use the domain are not destroyed, so references obtained while pinned
+/// stay valid.
+class MMEpochGuard
+{
+    friend class MMEpochDomain;
+
+private:
+    std::atomic<std::uint64_t>* slot;
+
+    inline MMEpochGuard(std::atomic<std::uint64_t>& mSlot) noexcept
+        : slot{&mSlot}
+    {
+    }
+
+public:
+    inline MMEpochGuard(const MMEpochGuard&) = delete;
+    inline MMEpochGuard(MMEpochGuard&& mX) noexcept : slot{mX.slot}
+    {
+        mX.slot = nullptr;
+    }
+
+    inline auto& operator=(const MMEpochGuard&) = delete;
+    inline auto& operator=(MMEpochGuard&&) = delete;
+
+    inline ~MMEpochGuard() noexcept
+    {
+        if(slot != nullptr) slot->store(0, std::memory_order_release);
+    }
+};
+
+/// @brief Epoch-based reclamation domain, shared by readers and by the
+/// managers whose objects they read.
+/// @details Readers `pin()` the current epoch before obtaining references
+/// to managed objects, from any thread. Managers with the domain set tag
+/// the objects destroyed by a refresh with the current epoch, advance it,
+/// and destroy (and recycle) the tagged objects only once every reader
+/// pinned at an older or equal epoch has released its pin.
+/// The number of concurrent pins is limited by the number of slots: when
+/// all slots are in use, `pin()` waits for one to be released.
+class MMEpochDomain
+{
+private:
+    struct alignas(64) Slot
+    {
+        // Pinned epoch, or 0 if the slot is free
+        std::atomic<std::uint64_t> epoch{0};
+    };
+
+    std::atomic<std::uint64_t> epoch{1};
+    std::unique_ptr<Slot[]> slots;
+    std::size_t slotCount;
+
+public:
+    inline MMEpochDomain(std::size_t mSlotCount = 64)
+        : slots{std::make_unique<Slot[]>(mSlotCount)}, slotCount{mSlotCount}
+    {
+        SSVU_ASSERT(mSlotCount > 0);
+    }
+
+    inline MMEpochDomain(const MMEpochDomain&) = delete;
+    inline auto& operator=(const MMEpochDomain&) = delete;
+
+    /// @brief Pins the current epoch. Can be called from any thread.
+    inline MMEpochGuard pin() noexcept
+    {
+        // Threads start looking from different slots, to avoid contention
+        auto start(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+
+        while(true)
+        {
+            for(auto i(0u); i < slotCount; ++i)
+            {
+                auto& s(slots[(start + i) % slotCount].epoch);
+                std::uint64_t expected{0};
+
+                // Pinning an outdated epoch is safe: it only delays the
+                // destruction of more objects
+                if(s.load(std::memory_order_relaxed) == 0 &&
+                    s.compare_exchange_strong(expected,
+                        epoch.load(std::memory_order_seq_cst),
+                        std::memory_order_seq_cst))
+                {
+                    // Orders the pin before the reads of managed objects
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+                    return MMEpochGuard{s};
+                }
+            }
+
+            std::this_thread::yield();
+        }
+    }
+
+    /// @brief Returns the current epoch.
+    inline auto getEpoch() const noexcept
+    {
+        return epoch.load(std::memory_order_seq_cst);
+    }
+
+    /// @brief Advances the current epoch. Called by the managers after
+    /// tagging the objects they destroy.
+    inline auto advance() noexcept
+    {
+        return epoch.fetch_add(1, std::memory_order_seq_cst) + 1;
+    }
+
+    /// @brief Returns the oldest pinned epoch, or the current epoch if no
+    /// epoch is pinned. Objects tagged with an older epoch cannot be
+    /// observed by any reader.
+    inline auto getSafeEpoch() const noexcept
+    {
+        auto result(getEpoch());
+        for(auto i(0u); i < slotCount; ++i)
+        {
+            auto e(slots[i].epoch.load(std::memory_order_seq_cst));
+            if(e != 0) result = std::min(result, e);
+        }
+
+        return result;
+    }
+};
+} // namespace ssvu
+
+#endif
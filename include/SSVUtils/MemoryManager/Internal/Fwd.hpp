@@ -5,6 +5,8 @@
 #ifndef SSVU_MEMORYMANAGER_INTERNAL_FWD
 #define SSVU_MEMORYMANAGER_INTERNAL_FWD
 
+#include "SSVUtils/GrowableArray/GrowableArray.hpp"
+
 // Forward declarations
 namespace ssvu
 {
@@ -12,12 +14,12 @@ namespace Impl
 {
 template <typename, template <typename> class, typename, typename>
 class BaseRecycler;
-template <typename, template <typename> class>
+template <typename, template <typename> class, typename>
 struct MonoRecyclerImpl;
 template <typename, template <typename> class, typename>
 struct PolyRecyclerImpl;
 
-template <typename, typename>
+template <typename, typename, template <typename> class = GrowableArrayAS>
 class BaseManager;
 } // namespace Impl
 } // namespace ssvu
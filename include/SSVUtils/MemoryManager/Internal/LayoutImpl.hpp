@@ -6,6 +6,13 @@
 #define SSVU_MEMORYMANAGER_INTERNAL_LAYOUTIMPL
 
 #include "SSVUtils/Core/Common/Aliases.hpp"
+#include "SSVUtils/Core/Assert/Assert.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
 
 namespace ssvu
 {
@@ -13,100 +20,185 @@ namespace Impl
 {
 namespace LayoutImpl
 {
-/// @brief Storage class for the the item, without a bool.
-template <typename T>
-struct LNoBool
-{
-    AlignedStorageFor<T> storageItem;
-};
+/// @brief Size of a cache line, in bytes. Used by the padded layouts.
+constexpr std::size_t cacheLineSize{64};
 
-/// @brief Storage class for the alive/dead boolean and the item.
-template <typename T>
-struct LBool
+/// @brief Size of the header that stores per-object data (alive flag or
+/// index) in the non-padded layouts.
+/// @details A multiple of the alignment of pointers, so that recycled
+/// memory (which starts with the header) can always store links to other
+/// recycled memory.
+constexpr std::size_t dataHeaderSize{alignof(void*)};
+
+inline constexpr std::size_t roundUp(
+    std::size_t mX, std::size_t mAlign) noexcept
 {
-    // `bool` must be the first member of the struct, as `T` is of
-    // variable size.
-    // Since we get instances of this struct by `TBase`, we cannot
-    // reliably get the bool address unless
-    // it's the first member in the struct.
-    AlignedStorageFor<bool> storageBool;
-    AlignedStorageFor<T> storageItem;
-};
+    return (mX + mAlign - 1) / mAlign * mAlign;
+}
 
 /// @brief Base class used for Layout CRTP.
-template <typename TBase, template <typename> class TLT>
+/// @details Every object is stored in a memory "block", that begins with a
+/// header of `THeaderSize` bytes, immediately followed by the object. The
+/// header size only depends on the layout, not on the object type, so that
+/// the block can always be retrieved from a `TBase` pointer, and the block
+/// of an object can be recycled for any other type of the same size. The
+/// allocator is responsible for aligning the object (not the block) to
+/// `getItemAlign<T>()`. In padded layouts objects are aligned to cache
+/// lines and blocks are padded to a multiple of the cache line size, so
+/// that objects never share cache lines.
+template <typename TBase, std::size_t THeaderSize, bool TPadded>
 struct LHelperBase
 {
-    using TLType = TLT<TBase>;
-    template <typename T>
-    using Lyt = TLT<T>;
+    static constexpr std::size_t headerSize{THeaderSize};
 
+    /// @brief Returns the required alignment of `T` objects.
     template <typename T>
-    inline static auto allocate()
+    inline static constexpr std::size_t getItemAlign() noexcept
     {
-        return reinterpret_cast<TLT<T>*>(new char[sizeof(TLT<T>)]);
+        return TPadded ? std::max(alignof(T), cacheLineSize) : alignof(T);
     }
-    inline static void deallocate(char* mPtr) noexcept
+
+    /// @brief Returns the size of the blocks of `T` objects.
+    template <typename T>
+    inline static constexpr std::size_t getBlockSize() noexcept
     {
-        SSVU_ASSERT(mPtr != nullptr);
-        delete[] mPtr;
+        return TPadded ? roundUp(headerSize + sizeof(T), cacheLineSize)
+                       : headerSize + sizeof(T);
     }
+
     inline static void destroy(TBase* mBase) noexcept(noexcept(mBase->~TBase()))
     {
         SSVU_ASSERT(mBase != nullptr);
         mBase->~TBase();
     }
 
-    inline static constexpr auto getLayout(TBase* mBase) noexcept
+    inline static auto getBlock(TBase* mBase) noexcept
     {
-        return SSVU_GET_BASEPTR_FROM_MEMBERPTR(TLType, mBase, storageItem);
+        return reinterpret_cast<char*>(mBase) - headerSize;
     }
-    inline static constexpr auto getLayout(const TBase* mBase) noexcept
+    inline static auto getBlock(const TBase* mBase) noexcept
     {
-        return SSVU_GET_BASEPTR_FROM_MEMBERPTR_CONST(
-            TLType, mBase, storageItem);
+        return reinterpret_cast<const char*>(mBase) - headerSize;
+    }
+
+protected:
+    template <typename T, typename... TArgs>
+    inline static T* constructItem(void* mBlock, TArgs&&... mArgs) noexcept(
+        noexcept(T(FWD(mArgs)...)))
+    {
+        SSVU_ASSERT(mBlock != nullptr);
+
+        auto result(new(static_cast<char*>(mBlock) + headerSize)
+                T(FWD(mArgs)...));
+
+        // The block is found from `TBase` pointers: the `TBase` subobject
+        // must be at the beginning of `T`
+        SSVU_ASSERT(static_cast<void*>(static_cast<TBase*>(result)) ==
+                    static_cast<void*>(result));
+        SSVU_ASSERT(reinterpret_cast<std::uintptr_t>(result) %
+                        getItemAlign<T>() ==
+                    0);
+        return result;
     }
 };
 
-/// @brief CRTP implementation for a layout with no extra bool.
-template <typename TBase>
-struct LHelperNoBool : public LHelperBase<TBase, LNoBool>
+/// @brief CRTP implementation for a layout with no extra data.
+template <typename TBase, bool TPadded>
+struct LHelperNoBoolImpl : public LHelperBase<TBase, 0, TPadded>
 {
+    static constexpr bool hasIdx{false};
+
     template <typename T, typename... TArgs>
-    inline static void construct(LNoBool<T>* mPtr, TArgs&&... mArgs) noexcept(
+    inline static T* construct(void* mBlock, TArgs&&... mArgs) noexcept(
         noexcept(T(FWD(mArgs)...)))
     {
-        SSVU_ASSERT(mPtr != nullptr);
-        new(&mPtr->storageItem) T(FWD(mArgs)...);
+        return LHelperNoBoolImpl::template constructItem<T>(
+            mBlock, FWD(mArgs)...);
     }
 };
 
-/// @brief CRTP implementation for a layout with a bool.
-template <typename TBase>
-struct LHelperBool : public LHelperBase<TBase, LBool>
+/// @brief CRTP implementation for a layout with an alive/dead bool.
+/// @details The bool is a relaxed atomic, so that readers on other threads
+/// can check it while the objects are deleted (see
+/// `BaseManager::setEpochDomain`).
+template <typename TBase, bool TPadded>
+struct LHelperBoolImpl
+    : public LHelperBase<TBase, TPadded ? cacheLineSize : dataHeaderSize,
+          TPadded>
 {
+    static constexpr bool hasIdx{false};
+
+    using Flag = std::atomic<bool>;
+    SSVU_ASSERT_STATIC_NM(sizeof(Flag) <= dataHeaderSize);
+
     template <typename T, typename... TArgs>
-    inline static void construct(LBool<T>* mPtr, TArgs&&... mArgs) noexcept(
+    inline static T* construct(void* mBlock, TArgs&&... mArgs) noexcept(
         noexcept(T(FWD(mArgs)...)))
     {
-        SSVU_ASSERT(mPtr != nullptr);
-        new(&mPtr->storageBool) bool{true};
-        new(&mPtr->storageItem) T(FWD(mArgs)...);
+        new(mBlock) Flag{true};
+        return LHelperBoolImpl::template constructItem<T>(
+            mBlock, FWD(mArgs)...);
     }
 
     inline static void setBool(TBase* mBase, bool mX) noexcept
     {
-        castStorage<bool>(LHelperBool::getLayout(mBase)->storageBool) = mX;
+        reinterpret_cast<Flag*>(LHelperBoolImpl::getBlock(mBase))
+            ->store(mX, std::memory_order_relaxed);
     }
     inline static bool getBool(const TBase* mBase) noexcept
     {
-        return castStorage<bool>(LHelperBool::getLayout(mBase)->storageBool);
+        return reinterpret_cast<const Flag*>(LHelperBoolImpl::getBlock(mBase))
+            ->load(std::memory_order_relaxed);
     }
 };
+
+/// @brief CRTP implementation for a layout with the index of the object in
+/// its manager. Alive/dead flags are stored by the manager, in a bitset.
+template <typename TBase, bool TPadded>
+struct LHelperIdxImpl
+    : public LHelperBase<TBase, TPadded ? cacheLineSize : dataHeaderSize,
+          TPadded>
+{
+    static constexpr bool hasIdx{true};
+
+    SSVU_ASSERT_STATIC_NM(sizeof(std::size_t) <= dataHeaderSize);
+
+    template <typename T, typename... TArgs>
+    inline static T* construct(void* mBlock, TArgs&&... mArgs) noexcept(
+        noexcept(T(FWD(mArgs)...)))
+    {
+        new(mBlock) std::size_t{0};
+        return LHelperIdxImpl::template constructItem<T>(
+            mBlock, FWD(mArgs)...);
+    }
+
+    inline static void setIdx(TBase* mBase, std::size_t mX) noexcept
+    {
+        *reinterpret_cast<std::size_t*>(LHelperIdxImpl::getBlock(mBase)) = mX;
+    }
+    inline static std::size_t getIdx(const TBase* mBase) noexcept
+    {
+        return *reinterpret_cast<const std::size_t*>(
+            LHelperIdxImpl::getBlock(mBase));
+    }
+};
+
+template <typename TBase>
+using LHelperNoBool = LHelperNoBoolImpl<TBase, false>;
+template <typename TBase>
+using LHelperNoBoolPadded = LHelperNoBoolImpl<TBase, true>;
+
+template <typename TBase>
+using LHelperBool = LHelperBoolImpl<TBase, false>;
+template <typename TBase>
+using LHelperBoolPadded = LHelperBoolImpl<TBase, true>;
+
+template <typename TBase>
+using LHelperIdx = LHelperIdxImpl<TBase, false>;
+template <typename TBase>
+using LHelperIdxPadded = LHelperIdxImpl<TBase, true>;
 } // namespace LayoutImpl
 } // namespace Impl
 } // namespace ssvu
 
 #endif
-
-// TODO: rewrite to be safer and aligned
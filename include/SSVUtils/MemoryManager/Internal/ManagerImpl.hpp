@@ -6,17 +6,38 @@
 #define SSVU_MEMORYMANAGER_INTERNAL_MANAGERIMPL
 
 #include "SSVUtils/Core/Common/Casts.hpp"
+#include "SSVUtils/Core/Common/LikelyUnlikely.hpp"
 #include "SSVUtils/Range/Range.hpp"
 #include "SSVUtils/MemoryManager/Internal/LayoutImpl.hpp"
 #include "SSVUtils/MemoryManager/Internal/StorageImpl.hpp"
 #include "SSVUtils/MemoryManager/Internal/RecyclerImpl.hpp"
+#include "SSVUtils/MemoryManager/Internal/ParallelImpl.hpp"
+#include "SSVUtils/MemoryManager/Internal/AliveImpl.hpp"
+#include "SSVUtils/MemoryManager/Internal/TypeRunsImpl.hpp"
+#include "SSVUtils/MemoryManager/Internal/EpochImpl.hpp"
 
+#include <algorithm>
+#include <cstdint>
 #include <vector>
 #include <memory>
+#include <thread>
+#include <type_traits>
+#include <utility>
 
 
 namespace ssvu
 {
+/// @brief Tells if `T` objects can be moved to another address by copying
+/// their bytes, without calling constructors or destructors. Required by
+/// `BaseManager::defragment`.
+/// @details True for trivially copyable types. Can be specialized for
+/// other types that are safe to relocate, such as polymorphic types without
+/// self-references.
+template <typename T>
+struct MMRelocatable : std::is_trivially_copyable<T>
+{
+};
+
 namespace Impl
 {
 template <typename T, typename TItrValue, typename TImpl>
@@ -74,10 +95,10 @@ class BaseRecVector
 {
 public:
     using LayoutType = LayoutImpl::LHelperNoBool<TBase>;
-    using ChunkType = Chunk<TBase, LayoutImpl::LHelperNoBool>;
-    using ChunkDeleterType = ChunkDeleter<TBase, LayoutImpl::LHelperNoBool>;
-    using PtrType = std::unique_ptr<TBase, ChunkDeleterType>;
     using RecyclerType = TRecycler;
+    using ChunkType = typename RecyclerType::ChunkType;
+    using ChunkDeleterType = typename RecyclerType::ChunkDeleterType;
+    using PtrType = typename RecyclerType::PtrType;
     using Container = std::vector<PtrType>;
 
 private:
@@ -102,6 +123,17 @@ public:
         return recycler.template getCreateEmplace<T>(items, FWD(mArgs)...);
     }
 
+    /// @brief Creates `mCount` `T` instances, constructed with `mArgs`, at
+    /// the end of the vector.
+    template <typename T = TBase, typename... TArgs>
+    inline void createN(std::size_t mCount, const TArgs&... mArgs)
+    {
+        items.reserve(items.size() + mCount);
+        recycler.template createN<T>(mCount,
+            [this](PtrType&& mPtr) { items.emplace_back(std::move(mPtr)); },
+            mArgs...);
+    }
+
     template <typename T = TBase, typename... TArgs>
     inline T& createAt(std::size_t mIdx, TArgs&&... mArgs)
     {
@@ -123,6 +155,34 @@ public:
     {
         items.clear();
     }
+    inline void shrink_to_fit()
+    {
+        items.shrink_to_fit();
+    }
+
+    /// @brief Returns the memory of recycled objects to the system,
+    /// keeping at most `mMaxFree` recycled objects per chunk. Returns the
+    /// number of released bytes. See `BaseRecycler::trim`.
+    inline std::size_t trim(std::size_t mMaxFree)
+    {
+        return recycler.trim(mMaxFree);
+    }
+
+    /// @brief Returns the memory of all recycled objects that can be
+    /// released to the system, and shrinks the vector to fit its size.
+    /// Returns the number of bytes released by the recycler.
+    inline std::size_t shrinkToFit()
+    {
+        items.shrink_to_fit();
+        return recycler.shrinkToFit();
+    }
+
+    /// @brief Enables automatic trimming of the recycler. See
+    /// `BaseRecycler::setAutoTrim`.
+    inline void setAutoTrim(std::size_t mHighWater, std::size_t mMaxFree = 0)
+    {
+        recycler.setAutoTrim(mHighWater, mMaxFree);
+    }
     inline auto size() const noexcept
     {
         return items.size();
@@ -183,27 +243,138 @@ public:
 /// @tparam TBase Base type of manager objects.
 /// @tparam TRecycler Internal recycler type. (MonoRecycler?
 /// PolyRecycler?)
-template <typename TBase, typename TRecycler>
+/// @tparam TContainer Storage type of the object pointers.
+/// (GrowableArrayAS? GrowableArrayVMAS?)
+/// @details The alive/dead flags of the objects are stored in their memory
+/// blocks if the recycler's layout has a bool, or in a bitset if the layout
+/// has an index.
+template <typename TBase, typename TRecycler,
+    template <typename> class TContainer>
 class BaseManager
 {
 public:
-    using LayoutType = LayoutImpl::LHelperBool<TBase>;
-    using ChunkType = Chunk<TBase, LayoutImpl::LHelperBool>;
-    using ChunkDeleterType = ChunkDeleter<TBase, LayoutImpl::LHelperBool>;
-    using PtrType = std::unique_ptr<TBase, ChunkDeleterType>;
     using RecyclerType = TRecycler;
-    using Container = GrowableArrayAS<PtrType>;
-    using ItrIdx = MMItrIdx<PtrType, BaseManager<TBase, TRecycler>>;
-    using ItrIdxC = MMItrIdx<PtrType, const BaseManager<TBase, TRecycler>>;
+    using LayoutType = typename RecyclerType::LayoutType;
+    using AliveType = std::conditional_t<LayoutType::hasIdx,
+        AliveBitset<TBase, LayoutType>, AliveFlags<TBase, LayoutType>>;
+    using ChunkType = typename RecyclerType::ChunkType;
+    using ChunkDeleterType = typename RecyclerType::ChunkDeleterType;
+    using PtrType = typename RecyclerType::PtrType;
+    using Container = TContainer<PtrType>;
+    using ItrIdx = MMItrIdx<PtrType, BaseManager>;
+    using ItrIdxC = MMItrIdx<PtrType, const BaseManager>;
 
 private:
     RecyclerType recycler;
     Container items;
+    AliveType alive;
     std::size_t msize{0u}, sizeNext{0u}, capacity{0u};
 
+    // Destination buffer of `refreshParallel`, swapped with `items`
+    Container scratch;
+    std::size_t scratchCapacity{0u};
+
+    bool autoTrim{false};
+
+    // Runs of objects of the same type, if grouping by type is enabled
+    TypeRuns<TBase> typeRuns;
+    bool groupByType{false};
+
+    // If epoch-based reclamation is enabled, objects removed by a refresh
+    // are kept here, tagged with their epoch, until no reader can see them
+    MMEpochDomain* epochs{nullptr};
+    std::vector<std::pair<std::uint64_t, PtrType>> retired;
+
+    // Position of the next object to relocate, during a defragmentation
+    bool defragmenting{false};
+    std::size_t defragNext{0u};
+
     inline bool isAliveAt(std::size_t mI) const noexcept
     {
-        return isAlive(items[mI].get());
+        return alive.isAliveAt(mI, items[mI].get());
+    }
+
+    /// @brief Removes the object at `mI` of `mC`, deferring its destruction.
+    inline void retireAt(Container& mC, std::size_t mI)
+    {
+        retired.emplace_back(epochs->getEpoch(), std::move(mC[mI]));
+        mC.deinitAt(mI);
+    }
+
+    // Every object may be retired by the next refresh or `clear`: their
+    // room is reserved when they are created, so that those never allocate
+    inline void reserveRetired(std::size_t mCount)
+    {
+        if(SSVU_LIKELY(epochs == nullptr)) return;
+
+        auto required(retired.size() + sizeNext + mCount);
+        if(retired.capacity() < required)
+            retired.reserve(std::max(required, retired.capacity() * 2));
+    }
+
+    inline void removeAt(std::size_t mI)
+    {
+        if(SSVU_UNLIKELY(epochs != nullptr))
+            retireAt(items, mI);
+        else
+            items.deinitAt(mI);
+    }
+
+    inline void reclaimAllRetired() noexcept
+    {
+        while(reclaimRetired() != 0) std::this_thread::yield();
+    }
+
+    inline void onRefreshed() noexcept
+    {
+        if(SSVU_UNLIKELY(groupByType)) tryRegroup();
+        if(SSVU_UNLIKELY(!retired.empty())) reclaimRetired();
+        if(SSVU_UNLIKELY(autoTrim)) recycler.checkAutoTrim();
+    }
+
+    // Grouping is an optimization: if it fails, the objects are left
+    // ungrouped until the next refresh
+    inline void tryRegroup() noexcept
+    {
+        try
+        {
+            regroup();
+        }
+        catch(...)
+        {
+        }
+    }
+
+    inline void regroup()
+    {
+        auto moved(typeRuns.group(msize,
+            [this](std::size_t mI) -> const TBase& { return *items[mI]; },
+            [this](std::size_t mI0, std::size_t mI1)
+            {
+                using std::swap;
+                swap(items[mI0], items[mI1]);
+            }));
+
+        // All objects are alive after a refresh: only positions change
+        if(moved)
+            for(auto i(0u); i < msize; ++i) alive.onMove(i, items[i].get());
+    }
+
+    template <typename T, typename TF>
+    inline bool tryForEachInRun(const TypeRun& mRun, const TF& mFn)
+    {
+        if(mRun.type != typeid(T)) return false;
+
+        for(auto i(mRun.begin); i < mRun.end; ++i)
+            mFn(castUp<T>(*items[i]));
+        return true;
+    }
+
+    template <typename T, typename TF>
+    inline void forEachOfTypeScan(const TF& mFn)
+    {
+        for(auto i(0u); i < msize; ++i)
+            if(typeid(*items[i]) == typeid(T)) mFn(castUp<T>(*items[i]));
     }
 
 public:
@@ -214,6 +385,7 @@ public:
     inline ~BaseManager()
     {
         clear();
+        reclaimAllRetired();
     }
 
     inline auto& getDataAt(std::size_t mI) noexcept
@@ -228,31 +400,134 @@ public:
     template <typename T = TBase, typename... TArgs>
     inline T& create(TArgs&&... mArgs)
     {
+        reserveRetired(1);
         auto uPtr(recycler.template create<T>(FWD(mArgs)...));
 
         if(capacity <= sizeNext) reserve(capacity * 3);
 
         items.initAt(sizeNext, std::move(uPtr));
+        alive.onCreate(sizeNext, items[sizeNext].get());
         return castUp<T>(*items[sizeNext++]);
     }
 
+    /// @brief Creates `mCount` `T` instances, constructed with `mArgs`.
+    /// @details Faster than repeated `create` calls: capacity is reserved
+    /// once, and the objects are created in a batch by the recycler.
+    template <typename T = TBase, typename... TArgs>
+    inline void createN(std::size_t mCount, const TArgs&... mArgs)
+    {
+        createRange<T>(mCount, [](T&, std::size_t) {}, mArgs...);
+    }
+
+    /// @brief Creates `mCount` `T` instances, constructed with `mArgs`,
+    /// then calls `mFn(obj, i)` on the `i`-th created object.
+    template <typename T = TBase, typename TF, typename... TArgs>
+    inline void createRange(
+        std::size_t mCount, const TF& mFn, const TArgs&... mArgs)
+    {
+        reserveRetired(mCount);
+        if(capacity < sizeNext + mCount)
+            reserve(std::max(capacity * 3, sizeNext + mCount));
+
+        auto first(sizeNext);
+        recycler.template createN<T>(mCount,
+            [this](PtrType&& mPtr)
+            {
+                items.initAt(sizeNext, std::move(mPtr));
+                alive.onCreate(sizeNext, items[sizeNext].get());
+                ++sizeNext;
+            },
+            mArgs...);
+
+        for(auto i(0u); i < mCount; ++i)
+            mFn(castUp<T>(*items[first + i]), i);
+    }
+
     inline void clear() noexcept
     {
-        for(auto i(0u); i < sizeNext; ++i) items.deinitAt(i);
+        for(auto i(0u); i < sizeNext; ++i)
+        {
+            // Readers may still check if retired objects are alive
+            if(SSVU_UNLIKELY(epochs != nullptr))
+                alive.delAt(i, items[i].get());
+
+            removeAt(i);
+        }
+
+        alive.clear(sizeNext);
+        typeRuns.invalidate();
         msize = sizeNext = 0;
     }
     inline void del(TBase& mBase) noexcept
     {
-        LayoutType::setBool(&mBase, false);
+        alive.del(mBase);
     }
 
+    /// @brief Deletes every object for which `mFn(obj)` returns true.
+    /// Objects created since the last refresh are not visited.
+    template <typename TF>
+    inline void delAll(const TF& mFn)
+    {
+        for(auto i(0u); i < msize; ++i)
+        {
+            auto ptr(items[i].get());
+            if(mFn(*ptr)) alive.delAt(i, ptr);
+        }
+    }
+
+    /// @brief Grows the capacity of the pointer array to `mCapacityNew`.
+    /// @details With `GrowableArrayVMAS` storage, pointers are never moved:
+    /// growing only commits new pages.
     inline void reserve(std::size_t mCapacityNew)
     {
         SSVU_ASSERT(capacity < mCapacityNew);
         items.grow(capacity, mCapacityNew);
+        alive.resize(capacity, mCapacityNew);
         capacity = mCapacityNew;
     }
 
+    /// @brief Returns the memory of recycled objects to the system,
+    /// keeping at most `mMaxFree` recycled objects per chunk. Returns the
+    /// number of released bytes. See `BaseRecycler::trim`.
+    inline std::size_t trim(std::size_t mMaxFree)
+    {
+        return recycler.trim(mMaxFree);
+    }
+
+    /// @brief Returns the memory of all recycled objects that can be
+    /// released to the system, and shrinks the internal arrays to the
+    /// current number of objects. Returns the number of released bytes.
+    inline std::size_t shrinkToFit()
+    {
+        if(!retired.empty()) reclaimRetired();
+
+        auto result(scratchCapacity * sizeof(PtrType));
+        scratch = Container{};
+        scratchCapacity = 0;
+
+        auto capacityNew(std::max(sizeNext, std::size_t(25)));
+        if(capacityNew < capacity)
+        {
+            items.shrink(sizeNext, capacityNew);
+            alive.resize(capacity, capacityNew);
+            result += (capacity - capacityNew) * sizeof(PtrType);
+            capacity = capacityNew;
+        }
+
+        return result + recycler.shrinkToFit();
+    }
+
+    /// @brief Enables automatic trimming of the recycler. See
+    /// `BaseRecycler::setAutoTrim`.
+    /// @details The recycler is also checked at the end of every refresh,
+    /// so that the objects destroyed by a refresh are trimmed to the
+    /// high-water mark.
+    inline void setAutoTrim(std::size_t mHighWater, std::size_t mMaxFree = 0)
+    {
+        recycler.setAutoTrim(mHighWater, mMaxFree);
+        autoTrim = mHighWater != AutoTrimSettings::disabled;
+    }
+
     inline void refresh() noexcept
     {
         Impl::refreshImpl(
@@ -260,13 +535,280 @@ public:
             [this](std::size_t mD, std::size_t mA) {
                 using std::swap;
                 swap(items[mD], items[mA]);
+                alive.onSwap(mD, items[mD].get(), mA, items[mA].get());
             },
-            [this](std::size_t mD) { items.deinitAt(mD); });
+            [this](std::size_t mD) { removeAt(mD); });
+
+        onRefreshed();
+    }
+
+    /// @brief Parallel version of `refresh()`, for big managers.
+    /// @details Alive objects are counted per block, and compacted in an
+    /// auxiliary buffer at the positions given by the prefix sums of the
+    /// counts; the order of alive objects is preserved. Dead objects are
+    /// destroyed in parallel, then their memory is recycled serially, as
+    /// chunks are not thread-safe. Falls back to `refresh()` if there are
+    /// too few objects.
+    inline void refreshParallel()
+    {
+        ParallelBlocks blocks{sizeNext};
+        if(blocks.getCount() == 1)
+        {
+            refresh();
+            return;
+        }
+
+        // Count alive objects, then turn counts into offsets
+        std::vector<std::size_t> offsets(blocks.getCount() + 1, 0);
+        blocks.run([this, &offsets](
+            std::size_t mBlock, std::size_t mBegin, std::size_t mEnd)
+            {
+                std::size_t count{0};
+                for(auto i(mBegin); i < mEnd; ++i) count += isAliveAt(i);
+                offsets[mBlock + 1] = count;
+            });
+
+        for(auto i(1u); i < offsets.size(); ++i) offsets[i] += offsets[i - 1];
+        auto aliveCount(offsets.back());
+
+        if(scratchCapacity < capacity)
+        {
+            scratch.grow(scratchCapacity, capacity);
+            scratchCapacity = capacity;
+        }
+
+        // Alive objects go to the front of `scratch`, dead objects (whose
+        // contents are destroyed) to the back
+        blocks.run([this, &offsets, aliveCount](
+            std::size_t mBlock, std::size_t mBegin, std::size_t mEnd)
+            {
+                auto iA(offsets[mBlock]);
+                auto iD(aliveCount + mBegin - offsets[mBlock]);
+
+                for(auto i(mBegin); i < mEnd; ++i)
+                {
+                    auto& p(items[i]);
+                    if(isAliveAt(i))
+                    {
+                        alive.onMove(iA, p.get());
+                        scratch.initAt(iA++, std::move(p));
+                    }
+                    else
+                    {
+                        if(SSVU_LIKELY(epochs == nullptr))
+                            ChunkDeleterType::destroy(p.get());
+
+                        scratch.initAt(iD++, std::move(p));
+                    }
+
+                    items.deinitAt(i);
+                }
+            });
+
+        for(auto i(aliveCount); i < sizeNext; ++i)
+        {
+            if(SSVU_UNLIKELY(epochs != nullptr))
+            {
+                retireAt(scratch, i);
+                continue;
+            }
+
+            auto& p(scratch[i]);
+            p.get_deleter().reclaim(p.release());
+            scratch.deinitAt(i);
+        }
+
+        std::swap(items, scratch);
+        std::swap(capacity, scratchCapacity);
+        alive.onCompact(aliveCount, sizeNext);
+        msize = sizeNext = aliveCount;
+
+        onRefreshed();
+    }
+
+    /// @brief Enables epoch-based reclamation through `mDomain`, or
+    /// disables it if `mDomain` is null.
+    /// @details Objects removed by a refresh (or `clear`) are not destroyed
+    /// immediately: their destruction and the recycling of their memory are
+    /// deferred until every reader that pinned an epoch of `mDomain` before
+    /// their removal has released its pin. References to managed objects
+    /// obtained while pinned stay valid until the pin is released, even
+    /// across refreshes on another thread; `isAlive` tells if the object
+    /// was deleted. Readers must not iterate the manager while it is being
+    /// refreshed. Changing the domain, and destroying the manager, wait for
+    /// the deferred objects to be destroyed.
+    inline void setEpochDomain(MMEpochDomain* mDomain)
+    {
+        reclaimAllRetired();
+        if(mDomain != nullptr) retired.reserve(sizeNext);
+        epochs = mDomain;
+    }
+
+    /// @brief Destroys the removed objects that no reader can observe
+    /// anymore. Called by every refresh. Returns the number of objects whose
+    /// destruction is still deferred.
+    inline std::size_t reclaimRetired() noexcept
+    {
+        if(retired.empty()) return 0;
+
+        // Readers that pin from now on cannot see the retired objects
+        epochs->advance();
+        auto safe(epochs->getSafeEpoch());
+
+        auto itr(std::find_if(std::begin(retired), std::end(retired),
+            [safe](const auto& mX) { return mX.first >= safe; }));
+        retired.erase(std::begin(retired), itr);
+        return retired.size();
+    }
+
+    /// @brief Returns the number of removed objects whose destruction is
+    /// deferred.
+    inline auto getRetiredCount() const noexcept
+    {
+        return retired.size();
+    }
+
+    /// @brief Moves the objects to new memory, in order, so that iterating
+    /// the manager accesses memory sequentially again. Works incrementally:
+    /// copies about `mBudget` bytes per call. Returns the number of copied
+    /// bytes. Requires `MMRelocatable<TBase>`.
+    /// @details A defragmentation pass starts when the manager's chunks
+    /// hold more recycled objects than a quarter of the alive objects, and
+    /// ends when every object was moved: emptied slabs are then returned to
+    /// the system. Objects of every chunk are moved to a new slab, in
+    /// manager order. `mOnRelocate(old, obj)` is called for every moved
+    /// object, with its old address (which must not be dereferenced), so
+    /// that external pointers can be updated; other references to moved
+    /// objects are invalidated. Objects reordered by a refresh during a pass
+    /// may be left in place until the next one. Not available with
+    /// epoch-based reclamation.
+    template <typename TF>
+    inline std::size_t defragment(std::size_t mBudget, const TF& mOnRelocate)
+    {
+        SSVU_ASSERT_STATIC(MMRelocatable<TBase>::value,
+            "Defragmentation requires relocatable objects");
+        SSVU_ASSERT(epochs == nullptr);
+
+        if(!defragmenting)
+        {
+            if(recycler.getFreeCount() * 4 <= msize) return 0;
+
+            defragmenting = true;
+            defragNext = 0;
+            recycler.beginRelocation();
+        }
+
+        std::size_t result{0};
+        while(defragNext < msize && result < mBudget)
+        {
+            auto& p(items[defragNext++]);
+            auto& chunk(p.get_deleter().getChunk());
+
+            auto old(p.release());
+            p.reset(chunk.relocate(old));
+            result += chunk.getSlotSize();
+
+            mOnRelocate(static_cast<const TBase*>(old), *p);
+        }
+
+        if(defragNext >= msize)
+        {
+            defragmenting = false;
+            recycler.trim(0);
+        }
+
+        return result;
+    }
+
+    inline std::size_t defragment(std::size_t mBudget)
+    {
+        return defragment(mBudget, [](const TBase*, TBase&) {});
+    }
+
+    /// @brief Returns true if a defragmentation pass is in progress.
+    inline auto isDefragmenting() const noexcept
+    {
+        return defragmenting;
+    }
+
+    /// @brief Keeps the objects grouped by dynamic type: every refresh
+    /// reorders the objects so that objects of the same type are
+    /// contiguous. Requires a polymorphic `TBase`.
+    /// @details Iterating grouped objects calls the same virtual functions
+    /// in a row, which improves branch prediction and instruction cache
+    /// usage. Grouping an already grouped array only counts the objects.
+    inline void setGroupByType(bool mX) noexcept
+    {
+        SSVU_ASSERT_STATIC(std::is_polymorphic_v<TBase>,
+            "Grouping by type requires a polymorphic base type");
+
+        groupByType = mX;
+        typeRuns.invalidate();
+    }
+
+    /// @brief Calls `mFn(obj)` for every object, type by type. Objects
+    /// whose dynamic type is one of `Ts` are passed as references to that
+    /// type, so that calls on them can be devirtualized; other objects are
+    /// passed as `TBase&`.
+    /// @details If grouping by type is enabled, every run of objects is
+    /// visited in a single pass. Otherwise, every type in `Ts` requires a
+    /// pass over all objects.
+    template <typename... Ts, typename TF>
+    inline void forEachByType(const TF& mFn)
+    {
+        if(groupByType && typeRuns.isValid())
+        {
+            for(const auto& r : typeRuns)
+            {
+                if((tryForEachInRun<Ts>(r, mFn) || ...)) continue;
+                for(auto i(r.begin); i < r.end; ++i) mFn(*items[i]);
+            }
+
+            return;
+        }
+
+        (forEachOfTypeScan<Ts>(mFn), ...);
+        for(auto i(0u); i < msize; ++i)
+        {
+            std::type_index type{typeid(*items[i])};
+            if(((type != typeid(Ts)) && ...)) mFn(*items[i]);
+        }
+    }
+
+    /// @brief Calls `mF(obj)` for every object, in parallel.
+    /// @details `mF` is called concurrently from multiple threads, and must
+    /// not throw. It must not create objects or refresh the manager, but
+    /// can `del` the object it was called on.
+    template <typename TF>
+    inline void forEachParallel(const TF& mF)
+    {
+        ParallelBlocks blocks{msize};
+        blocks.run([this, &mF](std::size_t, std::size_t mBegin,
+            std::size_t mEnd)
+            {
+                for(auto i(mBegin); i < mEnd; ++i) mF(*items[i]);
+            });
     }
 
+#if defined(SSVU_MEMORYMANAGER_STATS)
+    /// @brief Returns a snapshot of the allocation statistics.
+    inline auto getStats() const
+    {
+        auto result(recycler.getStats());
+        result.size = msize;
+        result.pending = sizeNext - msize;
+        result.retired = retired.size();
+        result.capacity = capacity;
+        result.bytesIndex = (capacity + scratchCapacity) * sizeof(PtrType);
+        return result;
+    }
+#endif
+
+    /// @brief Returns true if `mBase` was not deleted. Only available if
+    /// the flags are stored in the objects' memory blocks.
     inline static bool isAlive(const TBase* mBase) noexcept
     {
-        return LayoutType::getBool(mBase);
+        return AliveType::isAlive(mBase);
     }
     inline static bool isDead(const TBase* mBase) noexcept
     {
@@ -0,0 +1,217 @@
+// Copyright (c) 2013-2015 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: http://opensource.org/licenses/AFL-3.0
+
+#ifndef SSVU_MEMORYMANAGER_INTERNAL_PARALLELIMPL
+#define SSVU_MEMORYMANAGER_INTERNAL_PARALLELIMPL
+
+#include "SSVUtils/Core/Assert/Assert.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ssvu
+{
+namespace Impl
+{
+/// @brief Tuning parameters of the parallel manager operations.
+struct ParallelPolicy
+{
+    /// @brief Minimum number of objects processed by a single task.
+    /// Ranges smaller than this are processed serially.
+    static constexpr std::size_t minBlockSize{2048};
+
+    /// @brief Maximum number of tasks per thread, used to balance uneven
+    /// workloads.
+    static constexpr std::size_t blocksPerThread{4};
+};
+
+/// @brief Pool of worker threads used by the parallel manager operations.
+/// @details Workers are started on first use and sleep between jobs. The
+/// thread calling `run` takes part in the job. Jobs are executed one at a
+/// time: a job started from inside another job runs serially.
+class ParallelPool
+{
+private:
+    using JobFn = void (*)(const void*, std::size_t);
+
+    std::vector<std::thread> workers;
+
+    // Serializes concurrent `run` calls
+    std::mutex runMtx;
+
+    // Protects `generation`, `stopping` and `pending`
+    std::mutex mtx;
+    std::condition_variable cvWork, cvDone;
+    std::size_t generation{0}, pending{0};
+    bool stopping{false};
+
+    const void* jobCtx{nullptr};
+    JobFn jobFn{nullptr};
+    std::size_t jobCount{0};
+    std::atomic<std::size_t> nextTask{0};
+
+    inline static bool& isInJob() noexcept
+    {
+        thread_local bool result{false};
+        return result;
+    }
+
+    inline void work() noexcept
+    {
+        for(auto i(nextTask.fetch_add(1, std::memory_order_relaxed));
+            i < jobCount; i = nextTask.fetch_add(1, std::memory_order_relaxed))
+            jobFn(jobCtx, i);
+    }
+
+    inline void workerLoop()
+    {
+        isInJob() = true;
+        std::size_t lastGeneration{0};
+
+        while(true)
+        {
+            {
+                std::unique_lock<std::mutex> lock{mtx};
+                cvWork.wait(lock, [&]
+                    {
+                        return stopping || generation != lastGeneration;
+                    });
+
+                if(stopping) return;
+                lastGeneration = generation;
+            }
+
+            work();
+
+            std::lock_guard<std::mutex> lock{mtx};
+            if(--pending == 0) cvDone.notify_one();
+        }
+    }
+
+    inline ParallelPool()
+    {
+        auto n(std::thread::hardware_concurrency());
+        for(auto i(1u); i < n; ++i)
+            workers.emplace_back([this] { workerLoop(); });
+    }
+
+public:
+    inline static auto& get()
+    {
+        static ParallelPool instance;
+        return instance;
+    }
+
+    inline ParallelPool(const ParallelPool&) = delete;
+    inline auto& operator=(const ParallelPool&) = delete;
+
+    inline ~ParallelPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock{mtx};
+            stopping = true;
+        }
+
+        cvWork.notify_all();
+        for(auto& w : workers) w.join();
+    }
+
+    /// @brief Returns the number of threads that take part in a job,
+    /// including the calling one.
+    inline std::size_t getThreadCount() const noexcept
+    {
+        return workers.size() + 1;
+    }
+
+    /// @brief Calls `mF(i)` for every `i` in `[0, mCount)`, distributing
+    /// the calls among the threads of the pool. Returns when all calls
+    /// are done.
+    /// @details `mF` must not throw.
+    template <typename TF>
+    inline void run(std::size_t mCount, const TF& mF)
+    {
+        if(mCount <= 1 || workers.empty() || isInJob())
+        {
+            for(auto i(0u); i < mCount; ++i) mF(i);
+            return;
+        }
+
+        std::lock_guard<std::mutex> runLock{runMtx};
+        isInJob() = true;
+
+        jobCtx = &mF;
+        jobFn = [](const void* mCtx, std::size_t mI)
+        {
+            (*static_cast<const TF*>(mCtx))(mI);
+        };
+        jobCount = mCount;
+        nextTask.store(0, std::memory_order_relaxed);
+
+        {
+            std::lock_guard<std::mutex> lock{mtx};
+            ++generation;
+            pending = workers.size();
+        }
+
+        cvWork.notify_all();
+        work();
+
+        std::unique_lock<std::mutex> lock{mtx};
+        cvDone.wait(lock, [this] { return pending == 0; });
+        isInJob() = false;
+    }
+};
+
+/// @brief Split of `[0, mSize)` into blocks processed in parallel.
+/// @details Uses a single block (processed by the calling thread) if the
+/// range is small.
+class ParallelBlocks
+{
+private:
+    std::size_t size, count, blockSize;
+
+public:
+    inline ParallelBlocks(std::size_t mSize) : size{mSize}
+    {
+        using Policy = ParallelPolicy;
+        auto maxCount(
+            ParallelPool::get().getThreadCount() * Policy::blocksPerThread);
+
+        count = std::max(std::size_t(1),
+            std::min(mSize / Policy::minBlockSize, maxCount));
+        blockSize = (mSize + count - 1) / count;
+    }
+
+    inline auto getCount() const noexcept
+    {
+        return count;
+    }
+    inline auto getBegin(std::size_t mBlock) const noexcept
+    {
+        return std::min(mBlock * blockSize, size);
+    }
+    inline auto getEnd(std::size_t mBlock) const noexcept
+    {
+        return std::min(getBegin(mBlock) + blockSize, size);
+    }
+
+    /// @brief Calls `mF(block, begin, end)` for every block, in parallel.
+    template <typename TF>
+    inline void run(const TF& mF) const
+    {
+        ParallelPool::get().run(count, [&](std::size_t mBlock)
+            {
+                mF(mBlock, getBegin(mBlock), getEnd(mBlock));
+            });
+    }
+};
+} // namespace Impl
+} // namespace ssvu
+
+#endif
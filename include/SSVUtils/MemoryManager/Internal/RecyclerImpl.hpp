@@ -19,9 +19,9 @@ namespace ssvu
 {
 namespace Impl
 {
-template <typename TBase, template <typename> class TLHelper>
-using MonoRecyclerBase = BaseRecycler<TBase, TLHelper,
-    MonoStorage<TBase, TLHelper>, MonoRecyclerImpl<TBase, TLHelper>>;
+template <typename TBase, template <typename> class TLHelper, typename TStorage>
+using MonoRecyclerBase = BaseRecycler<TBase, TLHelper, TStorage,
+    MonoRecyclerImpl<TBase, TLHelper, TStorage>>;
 template <typename TBase, template <typename> class TLHelper, typename TStorage>
 using PolyRecyclerBase = BaseRecycler<TBase, TLHelper, TStorage,
     PolyRecyclerImpl<TBase, TLHelper, TStorage>>;
@@ -39,9 +39,9 @@ class BaseRecycler
 {
 public:
     using LayoutType = TLHelper<TBase>;
-    using ChunkType = Chunk<TBase, TLHelper>;
-    using ChunkDeleterType = ChunkDeleter<TBase, TLHelper>;
     using StorageType = TStorage;
+    using ChunkType = typename StorageType::ChunkType;
+    using ChunkDeleterType = ChunkDeleter<TBase, TLHelper, ChunkType>;
     using PtrType = std::unique_ptr<TBase, ChunkDeleterType>;
     using DerivedType = TDerived;
 
@@ -62,6 +62,23 @@ public:
         return getTD().template createImpl<T>(FWD(mArgs)...);
     }
 
+    /// @brief Creates `mCount` `T` instances, constructed with `mArgs`,
+    /// and calls `mF(ptr)` with a `PtrType` to each of them.
+    /// @details Faster than repeated `create` calls: the chunk is looked
+    /// up once, and new memory is carved out of a single slab.
+    template <typename T = TBase, typename TF, typename... TArgs>
+    inline void createN(
+        std::size_t mCount, const TF& mF, const TArgs&... mArgs)
+    {
+        auto& chunk(getTD().template getChunkImpl<T>());
+        chunk.template createN<T>(mCount,
+            [&mF, &chunk](T* mPtr)
+            {
+                mF(PtrType{mPtr, ChunkDeleterType{chunk}});
+            },
+            mArgs...);
+    }
+
     /// @brief Creates a `T` instance and emplaces its `PtrType` back
     /// into `mContainer`. Returns a reference to the instance.
     /// @param mContainer Container where the created `PtrType` will be
@@ -86,24 +103,105 @@ public:
             std::begin(mContainer) + mIdx, create<T>(FWD(mArgs)...)));
         return castUp<T>(**itr);
     }
+
+    /// @brief Returns the memory of recycled objects to the system,
+    /// keeping at most `mMaxFree` recycled objects per chunk. Returns the
+    /// number of released bytes.
+    /// @details Memory is released a slab at a time: recycled objects that
+    /// share a slab with objects in use are kept. Thread-safe recyclers
+    /// must not be used by other threads during the call.
+    inline std::size_t trim(std::size_t mMaxFree)
+    {
+        std::size_t result{0};
+        storage.forEachChunk([&result, mMaxFree](auto& mChunk)
+            {
+                result += mChunk.trim(mMaxFree);
+            });
+        return result;
+    }
+
+    /// @brief Returns the memory of all recycled objects that can be
+    /// released to the system. Returns the number of released bytes.
+    inline std::size_t shrinkToFit()
+    {
+        return trim(0);
+    }
+
+    /// @brief Enables automatic trimming: every chunk with more than
+    /// `mHighWater` recycled objects is trimmed to `mMaxFree`. Not
+    /// available for thread-safe recyclers.
+    inline void setAutoTrim(std::size_t mHighWater, std::size_t mMaxFree = 0)
+    {
+        storage.setAutoTrim(mHighWater, mMaxFree);
+    }
+
+    /// @brief Trims every chunk with more than `mHighWater` recycled
+    /// objects (see `setAutoTrim`), even if the objects could not be
+    /// released the last time. Called by managers after a refresh.
+    inline void checkAutoTrim()
+    {
+        storage.forEachChunk([](auto& mChunk) { mChunk.checkAutoTrim(); });
+    }
+
+    /// @brief Returns the number of recycled objects, in all chunks.
+    inline std::size_t getFreeCount()
+    {
+        std::size_t result{0};
+        storage.forEachChunk([&result](auto& mChunk)
+            {
+                result += mChunk.getFreeCount();
+            });
+        return result;
+    }
+
+    /// @brief Prepares every chunk for the relocation of all its objects.
+    /// See `Chunk::beginRelocation`.
+    inline void beginRelocation()
+    {
+        storage.forEachChunk([](auto& mChunk) { mChunk.beginRelocation(); });
+    }
+
+    /// @brief Disables automatic trimming.
+    inline void disableAutoTrim()
+    {
+        setAutoTrim(AutoTrimSettings::disabled);
+    }
+
+#if defined(SSVU_MEMORYMANAGER_STATS)
+    /// @brief Returns a snapshot of the allocation statistics.
+    inline auto getStats() const
+    {
+        MMStats result;
+        storage.fillStats(result);
+        return result;
+    }
+#endif
 };
 
 /// @brief CRTP implementation for `MonoRecycler`.
-template <typename TBase, template <typename> class TLHelper>
-struct MonoRecyclerImpl final : public MonoRecyclerBase<TBase, TLHelper>
+template <typename TBase, template <typename> class TLHelper, typename TStorage>
+struct MonoRecyclerImpl final
+    : public MonoRecyclerBase<TBase, TLHelper, TStorage>
 {
-    using BaseType = MonoRecyclerBase<TBase, TLHelper>;
+    using BaseType = MonoRecyclerBase<TBase, TLHelper, TStorage>;
     using PtrType = typename BaseType::PtrType;
     using ChunkDeleterType = typename BaseType::ChunkDeleterType;
 
-    template <typename T, typename... TArgs>
-    inline auto createImpl(TArgs&&... mArgs)
+    template <typename T>
+    inline auto& getChunkImpl() noexcept
     {
         SSVU_ASSERT_STATIC(std::is_same_v<TBase, T>,
             "MonoRecyclerImpl can only allocate objects "
             "of the same type");
-        return PtrType{this->storage.chunk.template create<T>(FWD(mArgs)...),
-            ChunkDeleterType{this->storage.chunk}};
+        return this->storage.chunk;
+    }
+
+    template <typename T, typename... TArgs>
+    inline auto createImpl(TArgs&&... mArgs)
+    {
+        auto& chunk(getChunkImpl<T>());
+        return PtrType{
+            chunk.template create<T>(FWD(mArgs)...), ChunkDeleterType{chunk}};
     }
 };
 
@@ -116,13 +214,19 @@ struct PolyRecyclerImpl final
     using PtrType = typename BaseType::PtrType;
     using ChunkDeleterType = typename BaseType::ChunkDeleterType;
 
-    template <typename T, typename... TArgs>
-    inline auto createImpl(TArgs&&... mArgs)
+    template <typename T>
+    inline auto& getChunkImpl()
     {
         SSVU_ASSERT_STATIC(isSameOrBaseOf<TBase, T>(),
             "PolyRecyclerImpl can only allocate types "
             "that belong to the same hierarchy");
-        auto& chunk(this->storage.template getChunk<T>());
+        return this->storage.template getChunk<T>();
+    }
+
+    template <typename T, typename... TArgs>
+    inline auto createImpl(TArgs&&... mArgs)
+    {
+        auto& chunk(getChunkImpl<T>());
         return PtrType{
             chunk.template create<T>(FWD(mArgs)...), ChunkDeleterType{chunk}};
     }
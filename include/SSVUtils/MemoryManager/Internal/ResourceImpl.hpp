@@ -0,0 +1,138 @@
+// Copyright (c) 2013-2015 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: http://opensource.org/licenses/AFL-3.0
+
+#ifndef SSVU_MEMORYMANAGER_INTERNAL_RESOURCEIMPL
+#define SSVU_MEMORYMANAGER_INTERNAL_RESOURCEIMPL
+
+#include "SSVUtils/Core/Common/LikelyUnlikely.hpp"
+#include "SSVUtils/MemoryManager/Internal/LayoutImpl.hpp"
+#include "SSVUtils/MemoryManager/Internal/StorageImpl.hpp"
+#include "SSVUtils/MemoryManager/Internal/StatsImpl.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <memory_resource>
+
+namespace ssvu
+{
+namespace Impl
+{
+/// @brief Unit of raw memory stored in the chunks of `MMPoolResource`.
+struct ResourceBlock
+{
+    void* link;
+};
+} // namespace Impl
+
+/// @brief Memory resource that recycles memory through the same size-class
+/// chunks and slabs used by `PolyRecycler`.
+/// @details Allocations up to `Impl::sizeClassMax` bytes, aligned to at
+/// most `Impl::sizeClassGranularity`, are served by the chunk of their size
+/// class: deallocated memory is kept for later allocations of the same
+/// class, and is released to the system only by `trim` or on destruction.
+/// Other allocations are forwarded to the upstream resource. Not
+/// thread-safe, like `std::pmr::unsynchronized_pool_resource`.
+class MMPoolResource : public std::pmr::memory_resource
+{
+private:
+    using ChunkType =
+        Impl::Chunk<Impl::ResourceBlock, Impl::LayoutImpl::LHelperNoBool>;
+
+    std::array<ChunkType, Impl::sizeClassCount> chunks;
+    std::pmr::memory_resource* upstream;
+
+    inline static bool isPooled(
+        std::size_t mBytes, std::size_t mAlign) noexcept
+    {
+        return Impl::hasSizeClass(mBytes, mAlign);
+    }
+
+protected:
+    inline void* do_allocate(std::size_t mBytes, std::size_t mAlign) override
+    {
+        if(SSVU_UNLIKELY(!isPooled(mBytes, mAlign)))
+            return upstream->allocate(mBytes, mAlign);
+
+        auto bytes(std::max(mBytes, sizeof(Impl::ResourceBlock)));
+        return chunks[Impl::getSizeClassIdx(bytes)].allocateRaw(bytes, mAlign);
+    }
+
+    inline void do_deallocate(
+        void* mPtr, std::size_t mBytes, std::size_t mAlign) override
+    {
+        if(SSVU_UNLIKELY(!isPooled(mBytes, mAlign)))
+        {
+            upstream->deallocate(mPtr, mBytes, mAlign);
+            return;
+        }
+
+        auto bytes(std::max(mBytes, sizeof(Impl::ResourceBlock)));
+        chunks[Impl::getSizeClassIdx(bytes)].deallocateRaw(mPtr);
+    }
+
+    inline bool do_is_equal(
+        const std::pmr::memory_resource& mX) const noexcept override
+    {
+        return this == &mX;
+    }
+
+public:
+    inline MMPoolResource(std::pmr::memory_resource* mUpstream =
+                              std::pmr::get_default_resource())
+        : upstream{mUpstream}
+    {
+        for(auto i(0u); i < Impl::sizeClassCount; ++i)
+            chunks[i].setMinSlot(
+                Impl::getSizeClassSize(i), Impl::sizeClassGranularity);
+    }
+
+    inline MMPoolResource(const MMPoolResource&) = delete;
+    inline auto& operator=(const MMPoolResource&) = delete;
+
+    /// @brief Returns the resource used for allocations that are not
+    /// pooled.
+    inline auto getUpstream() const noexcept
+    {
+        return upstream;
+    }
+
+    /// @brief Returns the memory of deallocated blocks to the system,
+    /// keeping at most `mMaxFree` blocks per size class. Returns the number
+    /// of released bytes. See `BaseRecycler::trim`.
+    inline std::size_t trim(std::size_t mMaxFree) noexcept
+    {
+        std::size_t result{0};
+        for(auto& c : chunks) result += c.trim(mMaxFree);
+        return result;
+    }
+
+    /// @brief Returns the memory of all deallocated blocks that can be
+    /// released to the system. Returns the number of released bytes.
+    inline std::size_t shrinkToFit() noexcept
+    {
+        return trim(0);
+    }
+
+    /// @brief Enables automatic trimming of every size class. See
+    /// `Chunk::setAutoTrim`.
+    inline void setAutoTrim(std::size_t mHighWater, std::size_t mMaxFree = 0)
+    {
+        for(auto& c : chunks) c.setAutoTrim(mHighWater, mMaxFree);
+    }
+
+#if defined(SSVU_MEMORYMANAGER_STATS)
+    /// @brief Returns a snapshot of the allocation statistics of the pooled
+    /// allocations. Upstream allocations are not included.
+    inline auto getStats() const
+    {
+        MMStats result;
+        for(const auto& c : chunks) result.addChunk(c.getStats());
+        return result;
+    }
+#endif
+};
+} // namespace ssvu
+
+#endif
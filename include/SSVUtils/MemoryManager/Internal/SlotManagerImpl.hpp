@@ -0,0 +1,293 @@
+// Copyright (c) 2013-2015 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: http://opensource.org/licenses/AFL-3.0
+
+#ifndef SSVU_MEMORYMANAGER_INTERNAL_SLOTMANAGERIMPL
+#define SSVU_MEMORYMANAGER_INTERNAL_SLOTMANAGERIMPL
+
+#include "SSVUtils/Core/Assert/Assert.hpp"
+#include "SSVUtils/Core/Common/Aliases.hpp"
+#include "SSVUtils/Internal/SharedFuncs.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace ssvu
+{
+namespace Impl
+{
+/// @brief Generation-checked handle to an object stored in a
+/// `SlotManagerImpl`.
+/// @details Stays valid until the object is removed by `refresh()`, even if
+/// the object is moved around in memory.
+struct SlotHandle
+{
+    static constexpr std::uint32_t nullIdx{
+        std::numeric_limits<std::uint32_t>::max()};
+
+    /// @brief Index of the slot.
+    std::uint32_t idx{nullIdx};
+
+    /// @brief Generation of the slot when the handle was created.
+    std::uint32_t gen{0};
+
+    inline bool isNull() const noexcept
+    {
+        return idx == nullIdx;
+    }
+
+    inline bool operator==(const SlotHandle& mH) const noexcept
+    {
+        return idx == mH.idx && gen == mH.gen;
+    }
+    inline bool operator!=(const SlotHandle& mH) const noexcept
+    {
+        return !(*this == mH);
+    }
+};
+
+/// @brief Slot-map memory manager class for a single type.
+/// @tparam T Type of manager objects. Must be movable and swappable.
+/// @details Objects are stored by value in a dense array, so that
+/// iteration is contiguous. A sparse array of slots maps the indices of
+/// `SlotHandle` instances to the current position of the objects. Like
+/// `BaseManager`, created objects become part of the iteration range and
+/// deleted objects are removed (and destroyed) only on `refresh()`.
+/// Removal moves objects around: references and pointers to objects are
+/// invalidated by `refresh()` and `create()`, handles are not.
+template <typename T>
+class SlotManagerImpl
+{
+public:
+    using Handle = SlotHandle;
+
+private:
+    struct Slot
+    {
+        // Index in the dense array if the slot is used, otherwise index of
+        // the next free slot
+        std::uint32_t denseIdx;
+        std::uint32_t gen;
+        bool alive;
+    };
+
+    std::vector<T> items;
+    std::vector<std::uint32_t> denseToSlot;
+    std::vector<Slot> slots;
+    std::uint32_t freeHead{Handle::nullIdx};
+    std::size_t msize{0u};
+
+    inline auto& getSlotAt(std::size_t mI) noexcept
+    {
+        return slots[denseToSlot[mI]];
+    }
+    inline const auto& getSlotAt(std::size_t mI) const noexcept
+    {
+        return slots[denseToSlot[mI]];
+    }
+
+    inline void freeSlotAt(std::size_t mI) noexcept
+    {
+        auto slotIdx(denseToSlot[mI]);
+        auto& s(slots[slotIdx]);
+
+        ++s.gen;
+        s.denseIdx = freeHead;
+        freeHead = slotIdx;
+    }
+
+    inline std::uint32_t acquireSlot()
+    {
+        if(freeHead == Handle::nullIdx)
+        {
+            SSVU_ASSERT(slots.size() < Handle::nullIdx);
+            slots.emplace_back(Slot{0, 0, false});
+            return slots.size() - 1;
+        }
+
+        auto result(freeHead);
+        freeHead = slots[result].denseIdx;
+        return result;
+    }
+
+public:
+    inline SlotManagerImpl()
+    {
+        reserve(25);
+    }
+
+    inline ~SlotManagerImpl()
+    {
+        clear();
+    }
+
+    /// @brief Creates a `T` instance and returns an handle to it.
+    template <typename... TArgs>
+    inline Handle create(TArgs&&... mArgs)
+    {
+        // The object is constructed before acquiring its slot, and removed
+        // if that throws, so that a failed creation leaves no trace
+        if(denseToSlot.size() == denseToSlot.capacity())
+            denseToSlot.reserve(std::max(
+                std::size_t(25), denseToSlot.capacity() * 2));
+
+        items.emplace_back(FWD(mArgs)...);
+
+        std::uint32_t slotIdx;
+        try
+        {
+            slotIdx = acquireSlot();
+        }
+        catch(...)
+        {
+            items.pop_back();
+            throw;
+        }
+
+        denseToSlot.emplace_back(slotIdx);
+
+        auto& s(slots[slotIdx]);
+        s.denseIdx = items.size() - 1;
+        s.alive = true;
+
+        return Handle{slotIdx, s.gen};
+    }
+
+    /// @brief Returns true if `mH` refers to an object that was not
+    /// removed yet.
+    inline bool isValid(const Handle& mH) const noexcept
+    {
+        return mH.idx < slots.size() && slots[mH.idx].gen == mH.gen;
+    }
+
+    /// @brief Returns true if `mH` refers to an object that was not
+    /// removed yet and was not deleted.
+    inline bool isAlive(const Handle& mH) const noexcept
+    {
+        return isValid(mH) && slots[mH.idx].alive;
+    }
+
+    /// @brief Returns a pointer to the object referred by `mH`, or
+    /// `nullptr` if `mH` is not valid.
+    inline T* get(const Handle& mH) noexcept
+    {
+        return isValid(mH) ? &items[slots[mH.idx].denseIdx] : nullptr;
+    }
+    inline const T* get(const Handle& mH) const noexcept
+    {
+        return isValid(mH) ? &items[slots[mH.idx].denseIdx] : nullptr;
+    }
+
+    inline T& operator[](const Handle& mH) noexcept
+    {
+        SSVU_ASSERT(isValid(mH));
+        return items[slots[mH.idx].denseIdx];
+    }
+    inline const T& operator[](const Handle& mH) const noexcept
+    {
+        SSVU_ASSERT(isValid(mH));
+        return items[slots[mH.idx].denseIdx];
+    }
+
+    /// @brief Returns an handle to the `mI`-th object of the dense array.
+    inline Handle getHandleAt(std::size_t mI) const noexcept
+    {
+        SSVU_ASSERT(mI < items.size());
+        return Handle{denseToSlot[mI], getSlotAt(mI).gen};
+    }
+
+    /// @brief Returns an handle to `mX`, which must be stored in the
+    /// manager.
+    inline Handle getHandle(const T& mX) const noexcept
+    {
+        return getHandleAt(&mX - items.data());
+    }
+
+    /// @brief Marks the object referred by `mH` as dead. It will be
+    /// destroyed on the next `refresh()`.
+    inline void del(const Handle& mH) noexcept
+    {
+        SSVU_ASSERT(isValid(mH));
+        slots[mH.idx].alive = false;
+    }
+
+    /// @brief Marks `mX`, which must be stored in the manager, as dead.
+    inline void del(const T& mX) noexcept
+    {
+        getSlotAt(&mX - items.data()).alive = false;
+    }
+
+    inline void clear() noexcept
+    {
+        for(auto i(0u); i < items.size(); ++i) freeSlotAt(i);
+        items.clear();
+        denseToSlot.clear();
+        msize = 0;
+    }
+
+    inline void reserve(std::size_t mCapacityNew)
+    {
+        items.reserve(mCapacityNew);
+        denseToSlot.reserve(mCapacityNew);
+        slots.reserve(mCapacityNew);
+    }
+
+    /// @brief Destroys dead objects, compacting the dense array, and makes
+    /// newly created objects part of the iteration range.
+    inline void refresh()
+    {
+        auto sizeNext(items.size());
+
+        Impl::refreshImpl(msize, sizeNext,
+            [this](std::size_t mI) { return getSlotAt(mI).alive; },
+            [this](std::size_t mD, std::size_t mA) {
+                using std::swap;
+                swap(items[mD], items[mA]);
+                swap(denseToSlot[mD], denseToSlot[mA]);
+                getSlotAt(mD).denseIdx = mD;
+                getSlotAt(mA).denseIdx = mA;
+            },
+            [this](std::size_t mD) { freeSlotAt(mD); });
+
+        items.erase(std::begin(items) + msize, std::end(items));
+        denseToSlot.resize(msize);
+    }
+
+    inline auto size() const noexcept
+    {
+        return msize;
+    }
+
+    // Dense iteration support
+    inline T* data() noexcept
+    {
+        return items.data();
+    }
+    inline const T* data() const noexcept
+    {
+        return items.data();
+    }
+    inline auto begin() noexcept
+    {
+        return items.data();
+    }
+    inline auto end() noexcept
+    {
+        return items.data() + msize;
+    }
+    inline auto begin() const noexcept
+    {
+        return items.data();
+    }
+    inline auto end() const noexcept
+    {
+        return items.data() + msize;
+    }
+};
+} // namespace Impl
+} // namespace ssvu
+
+#endif
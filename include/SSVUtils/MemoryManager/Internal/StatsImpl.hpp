@@ -0,0 +1,167 @@
+// Copyright (c) 2013-2015 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: http://opensource.org/licenses/AFL-3.0
+
+#ifndef SSVU_MEMORYMANAGER_INTERNAL_STATSIMPL
+#define SSVU_MEMORYMANAGER_INTERNAL_STATSIMPL
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+// Allocation statistics are opt-in: define `SSVU_MEMORYMANAGER_STATS`
+// before including the memory manager to enable the `getStats()` functions
+// and the counters they require.
+
+namespace ssvu
+{
+/// @brief Allocation statistics of a memory chunk.
+struct MMChunkStats
+{
+    /// @brief Size of the object slots, in bytes.
+    std::size_t slotSize{0u};
+
+    /// @brief Number of objects currently in use.
+    std::size_t live{0u};
+
+    /// @brief Number of recycled objects waiting to be reused.
+    std::size_t free{0u};
+
+    /// @brief Highest number of objects in use at the same time.
+    std::size_t peakLive{0u};
+
+    /// @brief Total number of created objects.
+    std::size_t created{0u};
+
+    /// @brief Total number of recycled objects.
+    std::size_t recycled{0u};
+
+    /// @brief Total number of objects created in recycled memory.
+    std::size_t reused{0u};
+
+    /// @brief Number of allocated slabs.
+    std::size_t slabCount{0u};
+
+    /// @brief Total bytes allocated for the slabs.
+    std::size_t bytesReserved{0u};
+
+    /// @brief Returns the ratio of creations that did not require new
+    /// memory.
+    inline double getReuseRatio() const noexcept
+    {
+        return created == 0 ? 0.0 : double(reused) / double(created);
+    }
+
+    /// @brief Returns a copy of these statistics, with the cumulative
+    /// counters (`created`, `recycled`, `reused`) relative to the older
+    /// snapshot `mPrev`.
+    /// @details Used to compute creation/recycling rates over an interval.
+    inline auto getSince(const MMChunkStats& mPrev) const noexcept
+    {
+        auto result(*this);
+        result.created -= mPrev.created;
+        result.recycled -= mPrev.recycled;
+        result.reused -= mPrev.reused;
+        return result;
+    }
+
+    /// @brief Adds the statistics of another chunk. The resulting
+    /// `peakLive` is the sum of the peaks, an upper bound of the real peak.
+    inline auto& operator+=(const MMChunkStats& mX) noexcept
+    {
+        slotSize = std::max(slotSize, mX.slotSize);
+        live += mX.live;
+        free += mX.free;
+        peakLive += mX.peakLive;
+        created += mX.created;
+        recycled += mX.recycled;
+        reused += mX.reused;
+        slabCount += mX.slabCount;
+        bytesReserved += mX.bytesReserved;
+        return *this;
+    }
+};
+
+/// @brief Snapshot of the allocation statistics of a recycler or manager.
+struct MMStats
+{
+    /// @brief Sum of the statistics of all chunks.
+    MMChunkStats total;
+
+    /// @brief Statistics of every used chunk. Polymorphic storages have one
+    /// chunk per size class (or per size, for big types).
+    std::vector<MMChunkStats> chunks;
+
+    /// @brief Number of alive objects of the manager.
+    std::size_t size{0u};
+
+    /// @brief Number of objects created since the last manager refresh.
+    std::size_t pending{0u};
+
+    /// @brief Number of removed objects whose destruction is deferred by
+    /// epoch-based reclamation.
+    std::size_t retired{0u};
+
+    /// @brief Capacity of the manager's pointer array.
+    std::size_t capacity{0u};
+
+    /// @brief Bytes allocated for the manager's pointer arrays.
+    std::size_t bytesIndex{0u};
+
+    /// @brief Adds the statistics of a chunk, if it was ever used.
+    inline void addChunk(const MMChunkStats& mX)
+    {
+        if(mX.created == 0 && mX.slabCount == 0) return;
+
+        chunks.emplace_back(mX);
+        total += mX;
+    }
+};
+
+namespace Impl
+{
+#if defined(SSVU_MEMORYMANAGER_STATS)
+/// @brief Counters used by `Chunk` to compute its statistics.
+struct ChunkCounters
+{
+    std::size_t slotSize{0u}, live{0u}, peakLive{0u};
+    std::size_t created{0u}, recycled{0u}, reused{0u};
+
+    inline void onCreate(std::size_t mSlotSize, bool mReused) noexcept
+    {
+        slotSize = std::max(slotSize, mSlotSize);
+        ++created;
+        if(mReused) ++reused;
+        peakLive = std::max(peakLive, ++live);
+    }
+    inline void onRecycle() noexcept
+    {
+        --live;
+        ++recycled;
+    }
+
+    inline void fill(MMChunkStats& mX) const noexcept
+    {
+        mX.slotSize = std::max(mX.slotSize, slotSize);
+        mX.live = live;
+        mX.peakLive = peakLive;
+        mX.created = created;
+        mX.recycled = recycled;
+        mX.reused = reused;
+    }
+};
+#else
+struct ChunkCounters
+{
+    inline void onCreate(std::size_t, bool) noexcept
+    {
+    }
+    inline void onRecycle() noexcept
+    {
+    }
+};
+#endif
+} // namespace Impl
+} // namespace ssvu
+
+#endif
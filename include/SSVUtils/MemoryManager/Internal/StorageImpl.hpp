@@ -7,31 +7,381 @@
 
 #include "SSVUtils/Core/Common/Casts.hpp"
 #include "SSVUtils/Core/Common/LikelyUnlikely.hpp"
+#include "SSVUtils/MemoryManager/Internal/StatsImpl.hpp"
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <new>
+#include <tuple>
 #include <unordered_map>
+#include <vector>
 
 namespace ssvu
 {
 namespace Impl
 {
+/// @brief Growth policy of the slabs allocated by `SlabAllocator`.
+/// @details The first slab of a chunk is small, so that rarely used types
+/// do not waste memory. Every following slab is twice as big as the
+/// previous one, up to `maxBytes`.
+struct SlabPolicy
+{
+    /// @brief Size of the first slab, in bytes.
+    static constexpr std::size_t initialBytes{4 * 1024};
+
+    /// @brief Maximum size of a slab, in bytes.
+    static constexpr std::size_t maxBytes{1024 * 1024};
+};
+
+/// @brief Granularity of the small size classes, in bytes. Also the
+/// alignment of the objects stored in size-class chunks.
+constexpr std::size_t sizeClassGranularity{16};
+
+/// @brief Biggest small size class: up to this size, classes are
+/// `sizeClassGranularity` bytes apart.
+constexpr std::size_t sizeClassLinearMax{256};
+
+/// @brief Biggest size class. Bigger objects do not use size classes.
+constexpr std::size_t sizeClassMax{64 * 1024};
+
+/// @brief Returns the index of the size class of objects of size `mSize`.
+/// @details Small sizes are rounded up to multiples of
+/// `sizeClassGranularity`. Bigger sizes are rounded up geometrically: every
+/// power-of-two interval is split in four classes, so that at most 25% of
+/// an object's slot is wasted.
+inline constexpr std::size_t getSizeClassIdx(std::size_t mSize) noexcept
+{
+    if(mSize <= sizeClassLinearMax)
+        return (std::max(mSize, std::size_t(1)) + sizeClassGranularity - 1) /
+                   sizeClassGranularity -
+               1;
+
+    // `mSize` is in `(2^k, 2^(k + 1)]`
+    auto k(0u);
+    while((std::size_t(2) << k) < mSize) ++k;
+
+    auto step((std::size_t(1) << k) / 4);
+    auto sub((mSize - (std::size_t(1) << k) + step - 1) / step - 1);
+
+    return sizeClassLinearMax / sizeClassGranularity + (k - 8) * 4 + sub;
+}
+
+/// @brief Returns the slot size of the size class with index `mIdx`.
+inline constexpr std::size_t getSizeClassSize(std::size_t mIdx) noexcept
+{
+    constexpr auto linearCount(sizeClassLinearMax / sizeClassGranularity);
+    if(mIdx < linearCount) return (mIdx + 1) * sizeClassGranularity;
+
+    auto k(8 + (mIdx - linearCount) / 4);
+    auto sub((mIdx - linearCount) % 4);
+    return (std::size_t(1) << k) + (sub + 1) * ((std::size_t(1) << k) / 4);
+}
+
+/// @brief Number of size classes.
+constexpr std::size_t sizeClassCount{getSizeClassIdx(sizeClassMax) + 1};
+
+SSVU_ASSERT_STATIC_NM(getSizeClassSize(sizeClassCount - 1) == sizeClassMax);
+
+/// @brief Internal slab allocator data structure.
+/// @details Allocates memory for objects by carving it out of big slabs,
+/// in order. Memory is never returned to the allocator: it is meant to be
+/// recycled through a `PtrChain`. Slabs whose memory is entirely recycled
+/// can be deallocated with `trim`. All the slabs are deallocated on
+/// destruction.
+class SlabAllocator
+{
+private:
+    /// @brief Header stored at the beginning of every slab.
+    struct SlabHeader
+    {
+        /// @brief Size of the slab, header included.
+        std::size_t bytes;
+
+        /// @brief Number of allocations carved out of the slab.
+        std::size_t carved;
+
+        /// @brief Number of recycled allocations. Only computed by `trim`.
+        std::size_t freeCount;
+
+        /// @brief True if the slab is being deallocated by `trim`.
+        bool released;
+    };
+
+    // Slabs sorted by address, to find the slab of an allocation
+    std::vector<SlabHeader*> slabs;
+    SlabHeader* current{nullptr};
+    std::uintptr_t cursor{0}, end{0};
+    std::size_t nextBytes{SlabPolicy::initialBytes};
+    std::size_t minSize{0}, minAlign{1};
+    std::size_t bytesReserved{0};
+
+    inline static constexpr std::uintptr_t alignUp(
+        std::uintptr_t mX, std::size_t mAlign) noexcept
+    {
+        return (mX + mAlign - 1) & ~std::uintptr_t(mAlign - 1);
+    }
+
+    inline static bool isBefore(const void* mA, const void* mB) noexcept
+    {
+        return std::less<const void*>{}(mA, mB);
+    }
+
+    inline void allocateSlab(std::size_t mMinBytes, bool mExact = false)
+    {
+        auto bytes(sizeof(SlabHeader) + mMinBytes);
+        if(!mExact) bytes = std::max(bytes, nextBytes);
+
+        // Reserve first, so that the insertion below cannot throw
+        slabs.reserve(slabs.size() + 1);
+
+        auto slab(new char[bytes]);
+        auto header(new(slab) SlabHeader{bytes, 0, 0, false});
+        slabs.insert(std::upper_bound(std::begin(slabs), std::end(slabs),
+                         header, &isBefore),
+            header);
+
+        current = header;
+        cursor = reinterpret_cast<std::uintptr_t>(slab + sizeof(SlabHeader));
+        end = reinterpret_cast<std::uintptr_t>(slab + bytes);
+        nextBytes = std::min(nextBytes * 2, SlabPolicy::maxBytes);
+
+        bytesReserved += bytes;
+    }
+
+    /// @brief Returns the slab that contains `mPtr`.
+    inline SlabHeader* findSlab(const char* mPtr) const noexcept
+    {
+        auto itr(std::upper_bound(std::begin(slabs), std::end(slabs), mPtr,
+            [](const char* mP, const SlabHeader* mS)
+            {
+                return isBefore(mP, mS);
+            }));
+
+        SSVU_ASSERT(itr != std::begin(slabs));
+        return *(itr - 1);
+    }
+
+    inline void release() noexcept
+    {
+        for(auto s : slabs) delete[] reinterpret_cast<char*>(s);
+        slabs.clear();
+        current = nullptr;
+    }
+
+public:
+    inline SlabAllocator() noexcept = default;
+
+    inline SlabAllocator(const SlabAllocator&) = delete;
+    inline SlabAllocator(SlabAllocator&& mSA) noexcept
+        : slabs{std::move(mSA.slabs)}, current{mSA.current},
+          cursor{mSA.cursor}, end{mSA.end}, nextBytes{mSA.nextBytes},
+          minSize{mSA.minSize}, minAlign{mSA.minAlign},
+          bytesReserved{mSA.bytesReserved}
+    {
+        mSA.slabs.clear();
+        mSA.current = nullptr;
+        mSA.cursor = mSA.end = 0;
+        mSA.nextBytes = SlabPolicy::initialBytes;
+        mSA.bytesReserved = 0;
+    }
+
+    inline auto& operator=(const SlabAllocator&) = delete;
+    inline auto& operator=(SlabAllocator&& mSA) noexcept
+    {
+        release();
+
+        slabs = std::move(mSA.slabs);
+        current = mSA.current;
+        cursor = mSA.cursor;
+        end = mSA.end;
+        nextBytes = mSA.nextBytes;
+        minSize = mSA.minSize;
+        minAlign = mSA.minAlign;
+        bytesReserved = mSA.bytesReserved;
+
+        mSA.slabs.clear();
+        mSA.current = nullptr;
+        mSA.cursor = mSA.end = 0;
+        mSA.nextBytes = SlabPolicy::initialBytes;
+        mSA.bytesReserved = 0;
+        return *this;
+    }
+
+    inline ~SlabAllocator() noexcept
+    {
+        release();
+    }
+
+    /// @brief Sets the minimum size and alignment of every allocation.
+    /// @details Used by size-class chunks, so that the memory of an object
+    /// can be recycled for any other type of the same size class.
+    inline void setMinSlot(std::size_t mSize, std::size_t mAlign) noexcept
+    {
+        minSize = mSize;
+        minAlign = mAlign;
+    }
+
+    /// @brief Returns the number of allocated slabs.
+    inline auto getSlabCount() const noexcept
+    {
+        return slabs.size();
+    }
+
+    /// @brief Returns the total bytes allocated for the slabs.
+    inline auto getBytesReserved() const noexcept
+    {
+        return bytesReserved;
+    }
+
+    /// @brief Returns the minimum size of every allocation.
+    inline auto getMinSize() const noexcept
+    {
+        return minSize;
+    }
+
+    /// @brief Returns the minimum alignment of every allocation.
+    inline auto getMinAlign() const noexcept
+    {
+        return minAlign;
+    }
+
+    /// @brief Returns `mSize` bytes of uninitialized memory, such that the
+    /// address `mOffset` bytes past its beginning is aligned to `mAlign`.
+    /// @details Used to align objects that follow a header (see
+    /// `LayoutImpl::LHelperBase`). The memory itself is always aligned for
+    /// pointers. Allocates a new slab only if the current one is full.
+    inline char* allocate(
+        std::size_t mSize, std::size_t mAlign, std::size_t mOffset = 0)
+    {
+        SSVU_ASSERT((mAlign & (mAlign - 1)) == 0);
+        SSVU_ASSERT(mOffset % alignof(void*) == 0);
+
+        auto size(std::max(mSize, minSize));
+        auto align(std::max({mAlign, minAlign, alignof(void*)}));
+        auto result(alignUp(cursor + mOffset, align) - mOffset);
+
+        if(SSVU_UNLIKELY(current == nullptr || result + size > end))
+        {
+            allocateSlab(size + align + mOffset);
+            result = alignUp(cursor + mOffset, align) - mOffset;
+        }
+
+        cursor = result + size;
+        ++current->carved;
+        return reinterpret_cast<char*>(result);
+    }
+
+    /// @brief Makes sure that the next `mCount` allocations with the same
+    /// parameters are carved out of the same slab.
+    inline void reserve(std::size_t mCount, std::size_t mSize,
+        std::size_t mAlign, std::size_t mOffset = 0)
+    {
+        auto align(std::max({mAlign, minAlign, alignof(void*)}));
+        auto stride(alignUp(std::max(mSize, minSize), align));
+        auto bytes(mCount * stride + align + mOffset);
+
+        if(current == nullptr || cursor + bytes > end) allocateSlab(bytes);
+    }
+
+    /// @brief Allocates a new slab, that fits exactly `mCount` allocations
+    /// with the same parameters. The next allocations are carved out of it.
+    inline void startSlab(std::size_t mCount, std::size_t mSize,
+        std::size_t mAlign, std::size_t mOffset = 0)
+    {
+        auto align(std::max({mAlign, minAlign, alignof(void*)}));
+        auto stride(alignUp(std::max(mSize, minSize), align));
+        allocateSlab(mCount * stride + align + mOffset, true);
+    }
+
+    /// @brief Returns the number of allocations carved out of all slabs.
+    inline auto getCarvedCount() const noexcept
+    {
+        std::size_t result{0};
+        for(auto s : slabs) result += s->carved;
+        return result;
+    }
+
+    /// @brief Deallocates slabs whose allocations are all recycled in
+    /// `mChain`, until at most `mMaxFree` allocations are left in it.
+    /// Returns the number of deallocated bytes.
+    /// @details Allocations in the deallocated slabs are removed from
+    /// `mChain`. Slabs that contain allocations in use are never
+    /// deallocated, so more than `mMaxFree` allocations can be left.
+    template <typename TChain>
+    inline std::size_t trim(TChain& mChain, std::size_t mMaxFree) noexcept
+    {
+        auto freeCount(mChain.getCount());
+        if(freeCount <= mMaxFree) return 0;
+
+        for(auto s : slabs) s->freeCount = 0;
+        mChain.forEach([this](char* mPtr) { ++findSlab(mPtr)->freeCount; });
+
+        auto releasedAny(false);
+        for(auto s : slabs)
+        {
+            if(freeCount <= mMaxFree) break;
+            if(s->freeCount != s->carved) continue;
+
+            s->released = releasedAny = true;
+            freeCount -= s->freeCount;
+        }
+
+        if(!releasedAny) return 0;
+        mChain.removeIf([this](char* mPtr)
+            {
+                return findSlab(mPtr)->released;
+            });
+
+        std::size_t result{0}, kept{0};
+        for(auto i(0u); i < slabs.size(); ++i)
+        {
+            auto s(slabs[i]);
+            if(!s->released)
+            {
+                slabs[kept++] = s;
+                continue;
+            }
+
+            // The next allocation will allocate a new slab
+            if(s == current)
+            {
+                current = nullptr;
+                cursor = end = 0;
+            }
+
+            result += s->bytes;
+            delete[] reinterpret_cast<char*>(s);
+        }
+
+        slabs.resize(kept);
+        bytesReserved -= result;
+        return result;
+    }
+};
+
 /// @brief Internal pointer chain data structure.
 /// @details Stored pointers contain a link to the next one in the chain
 /// when unused,
 /// otherwise they point to an allocated space that can be used for
 /// recycling.
-/// The memory pointed to from the stored pointers gets deallocated on
-/// destruction.
+/// The memory pointed to from the stored pointers is owned by the
+/// `SlabAllocator` of the same `Chunk`, and is not deallocated by the
+/// chain.
 template <typename TBase, template <typename> class TLHelper>
 class PtrChain
 {
 private:
-    using LHelperType = TLHelper<TBase>;
-
     struct Link
     {
         Link* next;
     };
     Link* base{nullptr};
+    std::size_t count{0};
 
 public:
     inline PtrChain() noexcept
@@ -44,27 +394,21 @@ public:
     inline PtrChain(PtrChain&& mPC) noexcept
     {
         base = mPC.base;
+        count = mPC.count;
         mPC.base = nullptr;
+        mPC.count = 0;
     }
 
     inline auto& operator=(const PtrChain&) = delete;
     inline auto& operator=(PtrChain&& mPC) noexcept
     {
         base = mPC.base;
+        count = mPC.count;
         mPC.base = nullptr;
+        mPC.count = 0;
         return *this;
     }
 
-    inline ~PtrChain() noexcept
-    {
-        while(base != nullptr)
-        {
-            auto temp(base);
-            base = base->next;
-            LHelperType::deallocate(reinterpret_cast<char*>(temp));
-        }
-    }
-
     /// @brief Push a pointer in the chain. Assumes the contents of the
     /// pointer were destroyed.
     template <typename T>
@@ -72,6 +416,7 @@ public:
     {
         reinterpret_cast<Link*>(mItem)->next = base;
         base = reinterpret_cast<Link*>(mItem);
+        ++count;
     }
 
     /// @brief Pops and returns a pointer from the chain.
@@ -80,31 +425,113 @@ public:
     {
         auto result(reinterpret_cast<char*>(base));
         base = base->next;
+        --count;
         return reinterpret_cast<T*>(result);
     }
 
+    /// @brief Calls `mF(ptr)` for every pointer in the chain.
+    template <typename TF>
+    inline void forEach(const TF& mF) const
+    {
+        for(auto l(base); l != nullptr; l = l->next)
+            mF(reinterpret_cast<char*>(l));
+    }
+
+    /// @brief Removes from the chain every pointer for which `mF(ptr)`
+    /// returns true.
+    template <typename TF>
+    inline void removeIf(const TF& mF)
+    {
+        auto link(&base);
+        while(*link != nullptr)
+        {
+            if(!mF(reinterpret_cast<char*>(*link)))
+            {
+                link = &(*link)->next;
+                continue;
+            }
+
+            *link = (*link)->next;
+            --count;
+        }
+    }
+
     /// @brief Returns true if the pointer chain is empty.
     inline bool isEmpty() const noexcept
     {
         return base == nullptr;
     }
+
+    /// @brief Returns the number of pointers in the chain.
+    inline auto getCount() const noexcept
+    {
+        return count;
+    }
+};
+
+/// @brief Settings of the automatic trimming of a chunk. See
+/// `Chunk::setAutoTrim`.
+struct AutoTrimSettings
+{
+    static constexpr std::size_t disabled{
+        std::numeric_limits<std::size_t>::max()};
+
+    std::size_t highWater{disabled}, maxFree{0};
+
+    // Number of recycled objects that triggers the next trim
+    std::size_t threshold{disabled};
 };
 
 /// @brief Memory "chunk" storage structure for a certain object type.
+/// @details New objects are carved out of slabs, so that they are
+/// contiguous in memory and only a few allocations are performed. Memory
+/// of destroyed objects is recycled through a `PtrChain`.
 template <typename TBase, template <typename> class TLHelper>
 class Chunk
 {
 private:
     using LHelperType = TLHelper<TBase>;
-    template <typename T>
-    using Lyt = typename LHelperType::template Lyt<T>;
-
     PtrChain<TBase, TLHelper> ptrChain;
+    SlabAllocator slabs;
+    ChunkCounters counters;
+    AutoTrimSettings autoTrim;
+
+    // Constructs a `T` in `mBlock`. If the constructor throws, the block
+    // is recycled before rethrowing
+    template <typename T, typename... TArgs>
+    inline T* constructAt(char* mBlock, bool mReused, TArgs&&... mArgs)
+    {
+        try
+        {
+            auto result(
+                LHelperType::template construct<T>(mBlock, FWD(mArgs)...));
+            counters.onCreate(
+                LHelperType::template getBlockSize<T>(), mReused);
+            return result;
+        }
+        catch(...)
+        {
+            ptrChain.push(mBlock);
+            throw;
+        }
+    }
+
+    inline void onHighWater() noexcept
+    {
+        trim(autoTrim.maxFree);
+
+        // If the recycled objects are spread over slabs in use, trimming
+        // again is delayed, so that its cost is amortized
+        autoTrim.threshold =
+            std::max(autoTrim.highWater, ptrChain.getCount() * 2);
+    }
 
 public:
     inline Chunk() noexcept = default;
     inline Chunk(const Chunk&) = delete;
-    inline Chunk(Chunk&& mC) noexcept : ptrChain(std::move(mC.ptrChain))
+    inline Chunk(Chunk&& mC) noexcept
+        : ptrChain(std::move(mC.ptrChain)), slabs(std::move(mC.slabs)),
+          counters(mC.counters), autoTrim(mC.autoTrim)
     {
     }
 
@@ -112,20 +539,59 @@ public:
     inline auto& operator=(Chunk&& mC) noexcept
     {
         ptrChain = std::move(mC.ptrChain);
+        slabs = std::move(mC.slabs);
+        counters = mC.counters;
+        autoTrim = mC.autoTrim;
         return *this;
     }
 
+    /// @brief Sets the minimum size and alignment of the object slots. See
+    /// `SlabAllocator::setMinSlot`.
+    inline void setMinSlot(std::size_t mSize, std::size_t mAlign) noexcept
+    {
+        slabs.setMinSlot(mSize, mAlign);
+    }
+
     /// @brief Creates and constructs a `T` instance.
     /// @details Uses one of the recyclable pointers if available,
-    /// otherwise allocates new memory.
+    /// otherwise carves new memory out of the current slab.
     template <typename T, typename... TArgs>
     inline T* create(TArgs&&... mArgs)
     {
-        auto result(SSVU_UNLIKELY(ptrChain.isEmpty())
-                        ? LHelperType::template allocate<T>()
-                        : ptrChain.template pop<Lyt<T>>());
-        LHelperType::template construct<T>(result, FWD(mArgs)...);
-        return castStorage<T>(&result->storageItem);
+        constexpr auto blockSize(LHelperType::template getBlockSize<T>());
+
+        auto reused(!ptrChain.isEmpty());
+        auto block(SSVU_UNLIKELY(!reused)
+                       ? slabs.allocate(blockSize,
+                             LHelperType::template getItemAlign<T>(),
+                             LHelperType::headerSize)
+                       : ptrChain.template pop<char>());
+        return constructAt<T>(block, reused, FWD(mArgs)...);
+    }
+
+    /// @brief Creates `mCount` `T` instances, constructed with `mArgs`,
+    /// and calls `mF(ptr)` for each of them.
+    /// @details Recyclable pointers are used first. The remaining objects
+    /// are carved out of a single slab.
+    template <typename T, typename TF, typename... TArgs>
+    inline void createN(
+        std::size_t mCount, const TF& mF, const TArgs&... mArgs)
+    {
+        constexpr auto blockSize(LHelperType::template getBlockSize<T>());
+        constexpr auto align(LHelperType::template getItemAlign<T>());
+
+        auto reusedCount(std::min(mCount, ptrChain.getCount()));
+        for(auto i(0u); i < reusedCount; ++i)
+            mF(constructAt<T>(ptrChain.template pop<char>(), true, mArgs...));
+
+        if(reusedCount == mCount) return;
+        slabs.reserve(
+            mCount - reusedCount, blockSize, align, LHelperType::headerSize);
+
+        for(auto i(reusedCount); i < mCount; ++i)
+            mF(constructAt<T>(
+                slabs.allocate(blockSize, align, LHelperType::headerSize),
+                false, mArgs...));
     }
 
     /// @brief Destroys a pointer that is in use. Memory does not get
@@ -134,16 +600,141 @@ public:
         noexcept(LHelperType::destroy(mBase)))
     {
         LHelperType::destroy(mBase);
-        ptrChain.push(LHelperType::getLayout(mBase));
+        reclaim(mBase);
     }
+
+    /// @brief Recycles the memory of a pointer whose contents were already
+    /// destroyed.
+    inline void reclaim(TBase* mBase) noexcept
+    {
+        deallocateRaw(LHelperType::getBlock(mBase));
+    }
+
+    /// @brief Returns `mSize` bytes of uninitialized memory aligned to
+    /// `mAlign`, without constructing an object.
+    /// @details Memory is recycled through the same chain as the objects:
+    /// `mSize` must not be bigger than the minimum slot size of the chunk,
+    /// and the chunk must only be used for raw memory. Used by
+    /// `MMPoolResource`.
+    inline void* allocateRaw(std::size_t mSize, std::size_t mAlign)
+    {
+        SSVU_ASSERT(mSize <= slabs.getMinSize());
+
+        auto reused(!ptrChain.isEmpty());
+        auto result(SSVU_UNLIKELY(!reused) ? slabs.allocate(mSize, mAlign)
+                                           : ptrChain.template pop<char>());
+        counters.onCreate(mSize, reused);
+        return result;
+    }
+
+    /// @brief Recycles memory returned by `allocateRaw`.
+    inline void deallocateRaw(void* mPtr) noexcept
+    {
+        ptrChain.push(static_cast<char*>(mPtr));
+        counters.onRecycle();
+
+        if(SSVU_UNLIKELY(ptrChain.getCount() > autoTrim.threshold))
+            onHighWater();
+    }
+
+    /// @brief Prepares the chunk for the relocation of all its objects: the
+    /// next objects are carved out of a new slab, that fits all of them.
+    /// @details Memory is carved out of the new slab even if the current
+    /// one is not full, so that the old slabs can be entirely recycled.
+    inline void beginRelocation()
+    {
+        auto live(slabs.getCarvedCount() - ptrChain.getCount());
+        if(live == 0) return;
+
+        slabs.startSlab(live, slabs.getMinSize(), slabs.getMinAlign(),
+            LHelperType::headerSize);
+    }
+
+    /// @brief Moves the object `mBase` to new memory carved out of the
+    /// current slab, recycles its old memory, and returns the moved object.
+    /// @details The block is copied byte by byte, header included: the
+    /// object must be trivially relocatable. Requires the slot size to be
+    /// set with `setMinSlot`. Used to defragment managers: relocated
+    /// objects are contiguous, in relocation order.
+    inline TBase* relocate(TBase* mBase)
+    {
+        SSVU_ASSERT(slabs.getMinSize() != 0);
+
+        auto size(slabs.getMinSize());
+        auto old(LHelperType::getBlock(mBase));
+        auto block(slabs.allocate(
+            size, slabs.getMinAlign(), LHelperType::headerSize));
+
+        std::memcpy(block, old, size);
+        ptrChain.push(old);
+        return reinterpret_cast<TBase*>(
+            block + (reinterpret_cast<char*>(mBase) - old));
+    }
+
+    /// @brief Returns the size of the object slots, if known.
+    inline auto getSlotSize() const noexcept
+    {
+        return slabs.getMinSize();
+    }
+
+    /// @brief Returns the number of recycled objects.
+    inline auto getFreeCount() const noexcept
+    {
+        return ptrChain.getCount();
+    }
+
+    /// @brief Returns the memory of recycled objects to the system, until
+    /// at most `mMaxFree` recycled objects are left. Returns the number of
+    /// released bytes.
+    /// @details Memory is released a slab at a time: recycled objects that
+    /// share a slab with objects in use are kept.
+    inline std::size_t trim(std::size_t mMaxFree) noexcept
+    {
+        return slabs.trim(ptrChain, mMaxFree);
+    }
+
+    /// @brief Trims the chunk if the number of recycled objects exceeds the
+    /// automatic trimming high-water mark.
+    inline void checkAutoTrim() noexcept
+    {
+        if(ptrChain.getCount() > autoTrim.highWater) onHighWater();
+    }
+
+    /// @brief Enables automatic trimming: when the number of recycled
+    /// objects exceeds `mHighWater`, the chunk is trimmed to `mMaxFree`.
+    /// Pass `AutoTrimSettings::disabled` as `mHighWater` to disable it.
+    inline void setAutoTrim(
+        std::size_t mHighWater, std::size_t mMaxFree) noexcept
+    {
+        SSVU_ASSERT(mMaxFree <= mHighWater);
+        autoTrim.highWater = autoTrim.threshold = mHighWater;
+        autoTrim.maxFree = mMaxFree;
+    }
+
+#if defined(SSVU_MEMORYMANAGER_STATS)
+    /// @brief Returns the allocation statistics of the chunk.
+    inline auto getStats() const noexcept
+    {
+        MMChunkStats result;
+        result.slotSize = slabs.getMinSize();
+        result.free = ptrChain.getCount();
+        result.slabCount = slabs.getSlabCount();
+        result.bytesReserved = slabs.getBytesReserved();
+        counters.fill(result);
+        return result;
+    }
+#endif
 };
 
 /// @brief Deleter functor used for the recycled smart pointers.
-template <typename TBase, template <typename> class TLHelper>
+/// @details If `TChunk` is thread-safe, pointers can be deleted from any
+/// thread.
+template <typename TBase, template <typename> class TLHelper,
+    typename TChunk = Chunk<TBase, TLHelper>>
 class ChunkDeleter
 {
 public:
-    using ChunkType = Chunk<TBase, TLHelper>;
+    using ChunkType = TChunk;
 
 private:
     ChunkType* chunk{nullptr};
@@ -153,25 +744,96 @@ public:
     inline ChunkDeleter(ChunkType& mChunk) noexcept : chunk{&mChunk}
     {
     }
+
+    /// @brief Returns the chunk that owns the deleted pointers.
+    inline auto& getChunk() const noexcept
+    {
+        SSVU_ASSERT(chunk != nullptr);
+        return *chunk;
+    }
     inline void operator()(TBase* mPtr) const
         noexcept(noexcept(chunk->recycle(mPtr)))
     {
         SSVU_ASSERT(chunk != nullptr);
         chunk->recycle(mPtr);
     }
+
+    /// @brief Destroys the contents of `mPtr`, without recycling its
+    /// memory. Does not access the chunk, so it can be called from any
+    /// thread.
+    inline static void destroy(TBase* mPtr) noexcept(
+        noexcept(TLHelper<TBase>::destroy(mPtr)))
+    {
+        TLHelper<TBase>::destroy(mPtr);
+    }
+
+    /// @brief Recycles the memory of `mPtr`, whose contents were destroyed
+    /// with `destroy`.
+    inline void reclaim(TBase* mPtr) const noexcept
+    {
+        SSVU_ASSERT(chunk != nullptr);
+        chunk->reclaim(mPtr);
+    }
 };
 
 /// @brief Storage data structure for a single type - uses a single
 /// `Chunk`.
-template <typename TBase, template <typename> class TLHelper>
+template <typename TBase, template <typename> class TLHelper,
+    typename TChunk = Chunk<TBase, TLHelper>>
 struct MonoStorage
 {
-    using ChunkType = Chunk<TBase, TLHelper>;
+    using ChunkType = TChunk;
     ChunkType chunk;
+
+    inline MonoStorage() noexcept
+    {
+        // Object slots have a known size, used by `Chunk::relocate`
+        chunk.setMinSlot(TLHelper<TBase>::template getBlockSize<TBase>(),
+            TLHelper<TBase>::template getItemAlign<TBase>());
+    }
+
+    template <typename TF>
+    inline void forEachChunk(const TF& mF)
+    {
+        mF(chunk);
+    }
+
+    inline void setAutoTrim(std::size_t mHighWater, std::size_t mMaxFree)
+    {
+        chunk.setAutoTrim(mHighWater, mMaxFree);
+    }
+
+#if defined(SSVU_MEMORYMANAGER_STATS)
+    inline void fillStats(MMStats& mX) const
+    {
+        mX.addChunk(chunk.getStats());
+    }
+#endif
 };
 
-/// @brief Storage data structure for multiple types (run-time) - uses a
-/// map of `Chunk` objects.
+/// @brief Returns true if objects with blocks of `mSize` bytes, aligned to
+/// `mAlign`, can be stored in size-class chunks.
+inline constexpr bool hasSizeClass(
+    std::size_t mSize, std::size_t mAlign) noexcept
+{
+    return mSize <= sizeClassMax && mAlign <= sizeClassGranularity;
+}
+
+/// @brief Returns the key of the chunk of objects with blocks of `mSize`
+/// bytes, aligned to `mAlign`, for types that do not use size classes.
+inline constexpr std::size_t getBigChunkKey(
+    std::size_t mSize, std::size_t mAlign) noexcept
+{
+    auto log2Align(0u);
+    while((std::size_t(1) << log2Align) < mAlign) ++log2Align;
+    return (mSize << 8) | log2Align;
+}
+
+/// @brief Storage data structure for multiple types (run-time) - uses an
+/// array of `Chunk` objects, one per size class.
+/// @details The chunk of a type is found at compile-time from its size:
+/// types of similar size share the same chunk (and slabs). Types that are
+/// too big or over-aligned use a map of `Chunk` objects instead.
 template <typename TBase, template <typename> class TLHelper>
 class PolyStorage
 {
@@ -179,32 +841,100 @@ public:
     using ChunkType = Chunk<TBase, TLHelper>;
 
 private:
-    std::unordered_map<std::size_t, ChunkType> chunks;
+    using LHelperType = TLHelper<TBase>;
+
+    std::array<ChunkType, sizeClassCount> chunks;
+    std::unordered_map<std::size_t, ChunkType> bigChunks;
+
+    // Applied to big chunks created later
+    AutoTrimSettings autoTrim;
 
 public:
+    inline PolyStorage() noexcept
+    {
+        for(auto i(0u); i < sizeClassCount; ++i)
+            chunks[i].setMinSlot(getSizeClassSize(i), sizeClassGranularity);
+    }
+
     template <typename T>
     inline auto& getChunk()
     {
-        return chunks[sizeof(T)];
+        constexpr auto size(LHelperType::template getBlockSize<T>());
+        constexpr auto align(LHelperType::template getItemAlign<T>());
+
+        if constexpr(hasSizeClass(size, align))
+        {
+            constexpr auto idx(getSizeClassIdx(size));
+            return chunks[idx];
+        }
+        else
+        {
+            auto res(bigChunks.try_emplace(getBigChunkKey(size, align)));
+            auto& chunk(res.first->second);
+            if(res.second)
+            {
+                chunk.setMinSlot(size, align);
+                chunk.setAutoTrim(autoTrim.highWater, autoTrim.maxFree);
+            }
+            return chunk;
+        }
     }
+
+    /// @brief Calls `mF(chunk)` for every chunk.
+    template <typename TF>
+    inline void forEachChunk(const TF& mF)
+    {
+        for(auto& c : chunks) mF(c);
+        for(auto& p : bigChunks) mF(p.second);
+    }
+
+    inline void setAutoTrim(std::size_t mHighWater, std::size_t mMaxFree)
+    {
+        autoTrim.highWater = mHighWater;
+        autoTrim.maxFree = mMaxFree;
+        forEachChunk([mHighWater, mMaxFree](auto& mChunk)
+            {
+                mChunk.setAutoTrim(mHighWater, mMaxFree);
+            });
+    }
+
+#if defined(SSVU_MEMORYMANAGER_STATS)
+    /// @brief Adds the statistics of every used size class, then of every
+    /// big type size.
+    inline void fillStats(MMStats& mX) const
+    {
+        for(const auto& c : chunks) mX.addChunk(c.getStats());
+        for(const auto& p : bigChunks) mX.addChunk(p.second.getStats());
+    }
+#endif
 };
 
 /// @brief Storage data structure for multiple types (compile-time) -
 /// uses a tuple of `Chunk` objects.
-template <typename TBase, template <typename> class TLHelper, typename TTypes>
+template <typename TBase, template <typename> class TLHelper, typename TTypes,
+    typename TChunk = Chunk<TBase, TLHelper>>
 class PolyFixedStorage
 {
 public:
-    using ChunkType = Chunk<TBase, TLHelper>;
+    using ChunkType = TChunk;
 
 private:
-    template <std::size_t TS>
+    using LHelperType = TLHelper<TBase>;
+
+    template <std::size_t TS, std::size_t TAlign>
     struct ChunkHolder
     {
         ChunkType chunk;
+
+        inline ChunkHolder() noexcept
+        {
+            chunk.setMinSlot(TS, TAlign);
+        }
     };
     template <typename T>
-    using ChunkHolderFor = ChunkHolder<sizeof(T)>;
+    using ChunkHolderFor =
+        ChunkHolder<LHelperType::template getBlockSize<T>(),
+            LHelperType::template getItemAlign<T>()>;
 
     using CHList = typename TTypes::template Apply<ChunkHolderFor>::Unique;
     using CHTpl = typename CHList::AsTpl;
@@ -219,6 +949,36 @@ public:
         SSVU_ASSERT_STATIC_NM(CHList::template has<ChunkHolderFor<T>>());
         return std::get<ChunkHolderFor<T>>(chTpl).chunk;
     }
+
+    /// @brief Calls `mF(chunk)` for every chunk.
+    template <typename TF>
+    inline void forEachChunk(const TF& mF)
+    {
+        std::apply([&mF](auto&... mCHs)
+            {
+                (mF(mCHs.chunk), ...);
+            },
+            chTpl);
+    }
+
+    inline void setAutoTrim(std::size_t mHighWater, std::size_t mMaxFree)
+    {
+        forEachChunk([mHighWater, mMaxFree](auto& mChunk)
+            {
+                mChunk.setAutoTrim(mHighWater, mMaxFree);
+            });
+    }
+
+#if defined(SSVU_MEMORYMANAGER_STATS)
+    inline void fillStats(MMStats& mX) const
+    {
+        std::apply([&mX](const auto&... mCHs)
+            {
+                (mX.addChunk(mCHs.chunk.getStats()), ...);
+            },
+            chTpl);
+    }
+#endif
 };
 } // namespace Impl
 } // namespace ssvu
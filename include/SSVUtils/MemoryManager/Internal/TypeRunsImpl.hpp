@@ -0,0 +1,142 @@
+// Copyright (c) 2013-2015 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: http://opensource.org/licenses/AFL-3.0
+
+#ifndef SSVU_MEMORYMANAGER_INTERNAL_TYPERUNSIMPL
+#define SSVU_MEMORYMANAGER_INTERNAL_TYPERUNSIMPL
+
+#include <cstddef>
+#include <typeindex>
+#include <typeinfo>
+#include <vector>
+
+namespace ssvu
+{
+namespace Impl
+{
+/// @brief Contiguous range of objects with the same dynamic type.
+struct TypeRun
+{
+    std::type_index type;
+    std::size_t begin, end;
+
+    // Used while grouping: position of the next object to place
+    std::size_t next;
+};
+
+/// @brief Groups the objects of a manager by dynamic type, and stores the
+/// resulting runs.
+/// @details Runs keep the order in which their types were first seen, so
+/// that regrouping an already grouped array does not move any object.
+template <typename TBase>
+class TypeRuns
+{
+private:
+    std::vector<TypeRun> runs;
+    std::size_t lastRun{0};
+    bool valid{false};
+
+    inline std::size_t getRunIdx(const TBase& mX)
+    {
+        std::type_index type{typeid(mX)};
+
+        // Consecutive objects usually have the same type
+        if(lastRun < runs.size() && runs[lastRun].type == type)
+            return lastRun;
+
+        for(auto i(0u); i < runs.size(); ++i)
+            if(runs[i].type == type) return lastRun = i;
+
+        runs.emplace_back(TypeRun{type, 0, 0, 0});
+        return lastRun = runs.size() - 1;
+    }
+
+public:
+    inline TypeRuns()
+    {
+        runs.reserve(16);
+    }
+
+    /// @brief Groups `mCount` objects by type, in place. `mGet(i)` must
+    /// return the `i`-th object, `mSwap(i, j)` must swap two objects.
+    /// Returns true if any object was moved.
+    /// @details Only counting the objects allocates, when new types are
+    /// seen: if that throws, no object was moved and the runs are left
+    /// invalid.
+    template <typename TGet, typename TSwap>
+    inline bool group(
+        std::size_t mCount, const TGet& mGet, const TSwap& mSwap)
+    {
+        valid = false;
+        for(auto& r : runs) r.end = 0;
+
+        // Count the objects of every type, checking if they are grouped
+        auto grouped(true);
+        std::size_t prevRun{0};
+        for(auto i(0u); i < mCount; ++i)
+        {
+            auto k(getRunIdx(mGet(i)));
+            ++runs[k].end;
+
+            grouped = grouped && k >= prevRun;
+            prevRun = k;
+        }
+
+        // Types without objects are forgotten
+        std::size_t kept{0};
+        for(auto i(0u); i < runs.size(); ++i)
+            if(runs[i].end != 0) runs[kept++] = runs[i];
+        runs.erase(std::begin(runs) + kept, std::end(runs));
+        lastRun = 0;
+
+        std::size_t offset{0};
+        for(auto& r : runs)
+        {
+            r.begin = r.next = offset;
+            offset += r.end;
+            r.end = offset;
+        }
+
+        valid = true;
+        if(grouped) return false;
+
+        // Every swap moves an object to its final run
+        for(auto k(0u); k < runs.size(); ++k)
+            while(runs[k].next < runs[k].end)
+            {
+                auto i(runs[k].next);
+                auto target(getRunIdx(mGet(i)));
+
+                if(target == k)
+                    ++runs[k].next;
+                else
+                    mSwap(i, runs[target].next++);
+            }
+
+        return true;
+    }
+
+    /// @brief Marks the runs as outdated, until the next `group` call.
+    inline void invalidate() noexcept
+    {
+        valid = false;
+    }
+
+    inline bool isValid() const noexcept
+    {
+        return valid;
+    }
+
+    inline auto begin() const noexcept
+    {
+        return std::begin(runs);
+    }
+    inline auto end() const noexcept
+    {
+        return std::end(runs);
+    }
+};
+} // namespace Impl
+} // namespace ssvu
+
+#endif
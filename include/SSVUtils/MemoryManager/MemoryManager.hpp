@@ -12,8 +12,13 @@
 // Implementations
 #include "SSVUtils/MemoryManager/Internal/LayoutImpl.hpp"
 #include "SSVUtils/MemoryManager/Internal/StorageImpl.hpp"
+#include "SSVUtils/MemoryManager/Internal/ConcurrentStorageImpl.hpp"
 #include "SSVUtils/MemoryManager/Internal/RecyclerImpl.hpp"
 #include "SSVUtils/MemoryManager/Internal/ManagerImpl.hpp"
+#include "SSVUtils/MemoryManager/Internal/SlotManagerImpl.hpp"
+#include "SSVUtils/MemoryManager/Internal/EpochImpl.hpp"
+#include "SSVUtils/MemoryManager/Internal/ResourceImpl.hpp"
+#include "SSVUtils/MemoryManager/Internal/DoubleBufferImpl.hpp"
 
 // User interface
 namespace ssvu
@@ -22,7 +27,8 @@ namespace ssvu
 /// additional information in the object.
 template <typename TBase>
 using MonoRecycler =
-    Impl::MonoRecyclerImpl<TBase, Impl::LayoutImpl::LHelperNoBool>;
+    Impl::MonoRecyclerImpl<TBase, Impl::LayoutImpl::LHelperNoBool,
+        Impl::MonoStorage<TBase, Impl::LayoutImpl::LHelperNoBool>>;
 
 /// @brief Memory recycler for multiple object types. Doesn't store
 /// additional information in the objects.
@@ -40,11 +46,39 @@ using PolyFixedRecycler =
         Impl::PolyFixedStorage<TBase, Impl::LayoutImpl::LHelperNoBool,
             MPL::List<Ts...>>>;
 
+/// @brief Thread-safe memory recycler for a single object type. Doesn't
+/// store additional information in the object. Objects can be created and
+/// destroyed from any thread.
+template <typename TBase>
+using ConcurrentMonoRecycler =
+    Impl::MonoRecyclerImpl<TBase, Impl::LayoutImpl::LHelperNoBool,
+        Impl::MonoStorage<TBase, Impl::LayoutImpl::LHelperNoBool,
+            Impl::ConcurrentChunk<TBase, Impl::LayoutImpl::LHelperNoBool>>>;
+
+/// @brief Thread-safe memory recycler for multiple object types. Doesn't
+/// store additional information in the objects. Objects can be created and
+/// destroyed from any thread.
+template <typename TBase>
+using ConcurrentPolyRecycler =
+    Impl::PolyRecyclerImpl<TBase, Impl::LayoutImpl::LHelperNoBool,
+        Impl::ConcurrentPolyStorage<TBase, Impl::LayoutImpl::LHelperNoBool>>;
+
+/// @brief Thread-safe memory recycler for multiple object types. Doesn't
+/// store additional information in the objects. Supports a fixed amount of
+/// object sizes. Objects can be created and destroyed from any thread.
+template <typename TBase, typename... Ts>
+using ConcurrentPolyFixedRecycler =
+    Impl::PolyRecyclerImpl<TBase, Impl::LayoutImpl::LHelperNoBool,
+        Impl::PolyFixedStorage<TBase, Impl::LayoutImpl::LHelperNoBool,
+            MPL::List<Ts...>,
+            Impl::ConcurrentChunk<TBase, Impl::LayoutImpl::LHelperNoBool>>>;
+
 /// @brief Memory recycler manager for a single object type. Stores an
 /// additional bool in every object.
 template <typename TBase>
 using MonoManager = Impl::BaseManager<TBase,
-    Impl::MonoRecyclerImpl<TBase, Impl::LayoutImpl::LHelperBool>>;
+    Impl::MonoRecyclerImpl<TBase, Impl::LayoutImpl::LHelperBool,
+        Impl::MonoStorage<TBase, Impl::LayoutImpl::LHelperBool>>>;
 
 /// @brief Memory recycler manager for multiple object types. Stores an
 /// additional bool in every object.
@@ -62,11 +96,78 @@ using PolyFixedManager = Impl::BaseManager<TBase,
         Impl::PolyFixedStorage<TBase, Impl::LayoutImpl::LHelperBool,
             MPL::List<Ts...>>>>;
 
+/// @brief Memory recycler manager for a single object type. Stores the
+/// index of every object in the object's memory block, and the alive/dead
+/// flags in a bitset. Refreshing does not access dead objects' memory, and
+/// `del` can be called concurrently on different objects.
+template <typename TBase>
+using BitsetMonoManager = Impl::BaseManager<TBase,
+    Impl::MonoRecyclerImpl<TBase, Impl::LayoutImpl::LHelperIdx,
+        Impl::MonoStorage<TBase, Impl::LayoutImpl::LHelperIdx>>>;
+
+/// @brief Memory recycler manager for multiple object types. Stores the
+/// index of every object in the object's memory block, and the alive/dead
+/// flags in a bitset.
+template <typename TBase>
+using BitsetPolyManager = Impl::BaseManager<TBase,
+    Impl::PolyRecyclerImpl<TBase, Impl::LayoutImpl::LHelperIdx,
+        Impl::PolyStorage<TBase, Impl::LayoutImpl::LHelperIdx>>>;
+
+/// @brief Like `BitsetMonoManager`, but every object is aligned to and
+/// padded to a multiple of the cache line size, so that different objects
+/// never share a cache line. Avoids false sharing when objects are updated
+/// from different threads.
+template <typename TBase>
+using PaddedMonoManager = Impl::BaseManager<TBase,
+    Impl::MonoRecyclerImpl<TBase, Impl::LayoutImpl::LHelperIdxPadded,
+        Impl::MonoStorage<TBase, Impl::LayoutImpl::LHelperIdxPadded>>>;
+
+/// @brief Like `BitsetPolyManager`, but every object is aligned to and
+/// padded to a multiple of the cache line size.
+template <typename TBase>
+using PaddedPolyManager = Impl::BaseManager<TBase,
+    Impl::PolyRecyclerImpl<TBase, Impl::LayoutImpl::LHelperIdxPadded,
+        Impl::PolyStorage<TBase, Impl::LayoutImpl::LHelperIdxPadded>>>;
+
+/// @brief Like `MonoManager`, but the object pointers are stored in a
+/// reserved range of virtual memory: growing the manager never moves them,
+/// and costs O(new pages).
+template <typename TBase>
+using VMMonoManager = Impl::BaseManager<TBase,
+    Impl::MonoRecyclerImpl<TBase, Impl::LayoutImpl::LHelperBool,
+        Impl::MonoStorage<TBase, Impl::LayoutImpl::LHelperBool>>,
+    GrowableArrayVMAS>;
+
+/// @brief Like `PolyManager`, but the object pointers are stored in a
+/// reserved range of virtual memory.
+template <typename TBase>
+using VMPolyManager = Impl::BaseManager<TBase,
+    Impl::PolyRecyclerImpl<TBase, Impl::LayoutImpl::LHelperBool,
+        Impl::PolyStorage<TBase, Impl::LayoutImpl::LHelperBool>>,
+    GrowableArrayVMAS>;
+
+/// @brief Generation-checked handle to an object stored in a
+/// `SlotManager`.
+using SlotHandle = Impl::SlotHandle;
+
+/// @brief Slot-map memory manager for a single object type. Stores objects
+/// by value in a dense array and hands out handles that stay valid across
+/// `refresh()` calls.
+template <typename T>
+using SlotManager = Impl::SlotManagerImpl<T>;
+
+/// @brief Memory manager for a single object type, whose objects are
+/// published as read-only snapshots that other threads can iterate without
+/// locks while the objects are being mutated.
+template <typename T>
+using DoubleBufferManager = Impl::DoubleBufferManagerImpl<T>;
+
 /// @brief `std::vector` + recycler wrapper class for a single object type.
 /// Doesn't store additional data in the object.
 template <typename TBase>
 using MonoRecVector = Impl::BaseRecVector<TBase,
-    Impl::MonoRecyclerImpl<TBase, Impl::LayoutImpl::LHelperNoBool>>;
+    Impl::MonoRecyclerImpl<TBase, Impl::LayoutImpl::LHelperNoBool,
+        Impl::MonoStorage<TBase, Impl::LayoutImpl::LHelperNoBool>>>;
 
 /// @brief `std::vector` + recycler wrapper class multiple object types.
 /// Doesn't store additional data in the objects.
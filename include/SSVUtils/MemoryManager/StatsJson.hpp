@@ -0,0 +1,20 @@
+// Copyright (c) 2013-2015 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: http://opensource.org/licenses/AFL-3.0
+
+#ifndef SSVU_MEMORYMANAGER_STATSJSON
+#define SSVU_MEMORYMANAGER_STATSJSON
+
+#include "SSVUtils/Json/Json.hpp"
+#include "SSVUtils/MemoryManager/MemoryManager.hpp"
+
+// JSON converters for the memory manager allocation statistics, so that
+// snapshots can be dumped with `ssvj::Val{stats}.getWriteToStr()`.
+
+SSVJ_CNV_OBJ_AUTO(ssvu::MMChunkStats, slotSize, live, free, peakLive, created,
+    recycled, reused, slabCount, bytesReserved)
+
+SSVJ_CNV_OBJ_AUTO(
+    ssvu::MMStats, total, chunks, size, pending, retired, capacity, bytesIndex)
+
+#endif
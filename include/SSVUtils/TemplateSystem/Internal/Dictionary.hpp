@@ -25,8 +25,10 @@ public:
     using DictVec = std::vector<Dictionary>;
 
 private:
-    VecMap<std::string, std::string> replacements;
-    VecMap<std::string, DictVec> sections;
+    // Keys and values are stored separately, so that lookups only touch
+    // the keys
+    VecMapSoA<std::string, std::string> replacements;
+    VecMapSoA<std::string, DictVec> sections;
     Dictionary* parentDict{nullptr};
 
     template <typename TKey>
@@ -142,8 +144,8 @@ private:
 
     inline void refreshParents()
     {
-        for(auto& v : sections)
-            for(auto& d : v.second)
+        for(auto& v : sections.getValues())
+            for(auto& d : v)
             {
                 d.parentDict = this;
                 d.refreshParents();
@@ -8,8 +8,38 @@
 
 #include "./utils/test_utils.hpp"
 
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
 #include <vector>
 
+// Type whose constructors throw on demand
+struct TCThrowKey
+{
+    static bool throwsOnDefault, throwsOnCopy;
+    int x;
+
+    TCThrowKey() : x{0}
+    {
+        if(throwsOnDefault) throw 0;
+    }
+    TCThrowKey(int mX) : x{mX} {}
+    TCThrowKey(const TCThrowKey& mK) : x{mK.x}
+    {
+        if(throwsOnCopy) throw 0;
+    }
+    TCThrowKey& operator=(const TCThrowKey&) = default;
+
+    bool operator<(const TCThrowKey& mK) const noexcept { return x < mK.x; }
+    bool operator==(const TCThrowKey& mK) const noexcept { return x == mK.x; }
+};
+
+bool TCThrowKey::throwsOnDefault{false};
+bool TCThrowKey::throwsOnCopy{false};
+
 int main()
 {
     {
@@ -120,4 +150,360 @@ int main()
             TEST_ASSERT(vs.size() == 0);
         }
     }
+    {
+        using namespace ssvu;
+
+        VecMap<int, std::string> tm{{5, "e"}, {1, "a"}, {3, "c"}};
+
+        std::vector<std::pair<int, std::string>> items{
+            {4, "d"}, {2, "b"}, {3, "x"}, {4, "y"}, {0, "z"}};
+
+        auto tmFirst(tm);
+        tm.insertBulk(items);
+        tmFirst.insertBulk(items, VecDupPolicy::KeepFirst);
+
+        TEST_ASSERT_OP(tm.size(), ==, 6);
+        TEST_ASSERT_OP(tmFirst.size(), ==, 6);
+
+        for(auto i(0u); i < tm.size(); ++i)
+        {
+            TEST_ASSERT_OP(tm.getData()[i].first, ==, i);
+            TEST_ASSERT_OP(tmFirst.getData()[i].first, ==, i);
+        }
+
+        std::string expected{"zabxye"}, expectedFirst{"zabcde"};
+        for(auto i(0u); i < tm.size(); ++i)
+        {
+            TEST_ASSERT_OP(tm.at(i)[0], ==, expected[i]);
+            TEST_ASSERT_OP(tmFirst.at(i)[0], ==, expectedFirst[i]);
+        }
+
+        // Builder: nothing is inserted until committed
+        auto b(tm.bulkBuilder());
+        b.add(10, "j").add(7, "g").add(10, "k");
+        TEST_ASSERT_OP(b.size(), ==, 3);
+        TEST_ASSERT(!tm.has(7));
+
+        b.commit();
+        TEST_ASSERT_OP(b.size(), ==, 0);
+        TEST_ASSERT_OP(tm.size(), ==, 8);
+
+        std::string g{"g"}, k{"k"};
+        TEST_ASSERT_OP(tm.at(7), ==, g);
+        TEST_ASSERT_OP(tm.at(10), ==, k);
+
+        // Empty bulk insertions
+        b.commit();
+        tm.insertBulk(std::vector<std::pair<int, std::string>>{});
+        TEST_ASSERT_OP(tm.size(), ==, 8);
+    }
+    {
+        using namespace ssvu;
+
+        // Random bulk insertions, checked against `std::map`
+        std::mt19937 rng{42};
+        std::uniform_int_distribution<int> dist(0, 500);
+
+        VecMap<int, int> tm;
+        std::map<int, int> expected;
+
+        for(auto r(0); r < 20; ++r)
+        {
+            std::vector<std::pair<int, int>> items;
+            for(auto i(0); i < 50; ++i)
+            {
+                items.emplace_back(dist(rng), r * 1000 + i);
+                expected[items.back().first] = items.back().second;
+            }
+
+            tm.insertBulk(std::move(items));
+
+            TEST_ASSERT_OP(tm.size(), ==, expected.size());
+            auto itr(std::begin(expected));
+            for(const auto& p : tm)
+            {
+                TEST_ASSERT_OP(p.first, ==, itr->first);
+                TEST_ASSERT_OP(p.second, ==, itr->second);
+                ++itr;
+            }
+        }
+    }
+    {
+        using namespace ssvu;
+
+        VecSorted<int, std::greater<int>> vs{3, 1, 2};
+        std::vector<int> items{5, 2, 0, 5, 4};
+
+        vs.insertBulk(std::begin(items), std::end(items));
+
+        std::vector<int> expected{5, 4, 3, 2, 1, 0};
+        TEST_ASSERT(vs.getData() == expected);
+
+        auto b(vs.bulkBuilder());
+        b.add(7);
+        b.add(-1);
+        b.commit();
+
+        TEST_ASSERT_OP(vs.size(), ==, 8);
+        TEST_ASSERT_OP(vs[0], ==, 7);
+        TEST_ASSERT_OP(vs[7], ==, -1);
+    }
+    {
+        using namespace ssvu;
+
+        // Lookups through the index match the binary search, for every
+        // tree shape
+        for(auto n(0); n < 70; ++n)
+        {
+            VecMap<int, int> tm;
+            for(auto i(0); i < n; ++i) tm[i * 2] = i;
+
+            auto indexed(tm);
+            indexed.buildIndex();
+            TEST_ASSERT(indexed.hasIndex());
+            TEST_ASSERT(!tm.hasIndex());
+
+            for(auto k(-1); k <= n * 2 + 1; ++k)
+            {
+                TEST_ASSERT_OP(indexed.has(k), ==, tm.has(k));
+                TEST_ASSERT_OP(indexed.count(k), ==, tm.count(k));
+                TEST_ASSERT_OP(indexed.atItr(k) - std::begin(indexed), ==,
+                    tm.atItr(k) - std::begin(tm));
+            }
+        }
+    }
+    {
+        using namespace ssvu;
+
+        VecMap<double, int> tm;
+        std::vector<std::pair<double, int>> items;
+        for(auto i(0); i < 300; ++i) items.emplace_back(i * 7 % 300 * 0.5, i);
+
+        tm.insertBulk(items);
+        tm.buildIndex();
+
+        for(auto i(0); i < 300; ++i)
+            TEST_ASSERT_OP(tm.at(i * 7 % 300 * 0.5), ==, i);
+        TEST_ASSERT(!tm.has(150.0));
+        TEST_ASSERT(!tm.has(-1.0));
+        TEST_ASSERT(!tm.has(0.25));
+
+        // Copies keep the index, iteration order is unchanged
+        const auto copy(tm);
+        TEST_ASSERT(copy.hasIndex());
+        TEST_ASSERT(copy == tm);
+        TEST_ASSERT(std::is_sorted(std::begin(copy), std::end(copy)));
+
+        // Bulk insertions rebuild the index, single insertions drop it
+        tm.insertBulk(std::vector<std::pair<double, int>>{{1000.0, 1}});
+        TEST_ASSERT(tm.hasIndex());
+        TEST_ASSERT(tm.has(1000.0));
+
+        tm[-5.0] = 2;
+        TEST_ASSERT(!tm.hasIndex());
+        TEST_ASSERT_OP(tm.at(-5.0), ==, 2);
+
+        tm.buildIndex();
+        tm.getData();
+        TEST_ASSERT(!tm.hasIndex());
+
+        tm.buildIndex();
+        tm.clear();
+        TEST_ASSERT(!tm.hasIndex());
+        TEST_ASSERT(!tm.has(-5.0));
+    }
+    {
+        using namespace ssvu;
+
+        VecSorted<int, std::greater<int>> vs{9, 3, 6};
+        vs.buildIndex();
+
+        TEST_ASSERT(vs.has(6));
+        TEST_ASSERT(!vs.has(5));
+        TEST_ASSERT_OP(*vs.atItr(3), ==, 3);
+        TEST_ASSERT(vs.atItr(4) == std::end(vs));
+
+        vs.insert(4);
+        TEST_ASSERT(!vs.hasIndex());
+        TEST_ASSERT(vs.has(4));
+    }
+    {
+        using namespace ssvu;
+
+        // The split layout behaves like the default one
+        std::mt19937 rng{42};
+        std::uniform_int_distribution<int> dist(0, 200);
+
+        VecMap<int, std::string> aos;
+        VecMapSoA<int, std::string> soa;
+        std::vector<std::pair<int, std::string>> items;
+        for(auto i(0); i < 300; ++i)
+        {
+            auto k(dist(rng));
+            if(i % 3 == 0)
+            {
+                aos[k] = std::to_string(i);
+                soa[k] = std::to_string(i);
+            }
+            else
+                items.emplace_back(k, std::to_string(i));
+
+            if(i % 50 == 49)
+            {
+                auto policy(i % 100 == 49 ? VecDupPolicy::KeepFirst
+                                          : VecDupPolicy::KeepLast);
+                aos.insertBulk(items, policy);
+                soa.insertBulk(items, policy);
+                items.clear();
+            }
+        }
+
+        TEST_ASSERT_OP(soa.size(), ==, aos.size());
+        TEST_ASSERT(std::is_sorted(
+            std::begin(soa.getKeys()), std::end(soa.getKeys())));
+
+        auto itr(std::begin(soa));
+        for(const auto& p : aos)
+        {
+            TEST_ASSERT_OP(itr->first, ==, p.first);
+            TEST_ASSERT_OP(itr->second, ==, p.second);
+            TEST_ASSERT_OP(soa.at(p.first), ==, p.second);
+            ++itr;
+        }
+        TEST_ASSERT(itr == std::end(soa));
+
+        for(auto k(-1); k <= 201; ++k)
+        {
+            TEST_ASSERT_OP(soa.count(k), ==, aos.count(k));
+            TEST_ASSERT_OP(soa.atItr(k) - std::begin(soa), ==,
+                aos.atItr(k) - std::begin(aos));
+        }
+    }
+    {
+        using namespace ssvu;
+
+        VecMapSoA<double, int> tm{{2.0, 1}, {1.0, 2}, {2.0, 3}};
+        TEST_ASSERT_OP(tm.size(), ==, 2);
+        TEST_ASSERT_OP(tm.at(1.0), ==, 2);
+        TEST_ASSERT_OP(tm.at(2.0), ==, 3);
+        TEST_ASSERT_OP(tm.atOrDefault(3.0), ==, 0);
+
+        // Values are stored densely, in key order
+        for(auto&& p : tm) p.second *= 10;
+        TEST_ASSERT_OP(tm.getValues()[0], ==, 20);
+        TEST_ASSERT_OP(tm.getValues()[1], ==, 30);
+
+        auto b(tm.bulkBuilder());
+        for(auto i(0); i < 100; ++i) b.add(i * 0.5, i);
+        b.commit();
+        TEST_ASSERT_OP(tm.size(), ==, 100);
+        TEST_ASSERT_OP(tm.at(2.0), ==, 4);
+
+        // The index is rebuilt by bulk insertions, dropped otherwise
+        tm.buildIndex();
+        const auto copy(tm);
+        TEST_ASSERT(copy.hasIndex());
+        TEST_ASSERT(copy == tm);
+        for(auto i(0); i < 100; ++i) TEST_ASSERT_OP(copy.at(i * 0.5), ==, i);
+        TEST_ASSERT(!copy.has(0.25));
+        TEST_ASSERT(!copy.has(100.0));
+
+        tm.insertBulk(std::vector<std::pair<double, int>>{{-1.0, 7}});
+        TEST_ASSERT(tm.hasIndex());
+        TEST_ASSERT_OP(tm.at(-1.0), ==, 7);
+
+        tm[-2.0] = 8;
+        TEST_ASSERT(!tm.hasIndex());
+        TEST_ASSERT(tm != copy);
+        TEST_ASSERT_OP((*std::begin(tm)).second, ==, 8);
+
+        tm.buildIndex();
+        tm.clear();
+        TEST_ASSERT(!tm.hasIndex());
+        TEST_ASSERT(tm.empty());
+    }
+    {
+        using namespace ssvu;
+
+        // Keys and values stay in sync when inserting a key throws
+        VecMapSoA<TCThrowKey, int> tm;
+        tm[TCThrowKey{1}] = 1;
+        tm[TCThrowKey{3}] = 3;
+
+        TCThrowKey k{2};
+        auto threw(false);
+        TCThrowKey::throwsOnCopy = true;
+        try
+        {
+            tm[k] = 2;
+        }
+        catch(int)
+        {
+            threw = true;
+        }
+        TCThrowKey::throwsOnCopy = false;
+        TEST_ASSERT(threw);
+        TEST_ASSERT_OP(tm.size(), ==, 2);
+        TEST_ASSERT_OP(tm.getValues().size(), ==, 2);
+        TEST_ASSERT_OP(tm.at(TCThrowKey{3}), ==, 3);
+
+        std::vector<std::pair<TCThrowKey, int>> items;
+        items.emplace_back(TCThrowKey{0}, 0);
+        items.emplace_back(TCThrowKey{4}, 4);
+        threw = false;
+        TCThrowKey::throwsOnDefault = true;
+        try
+        {
+            tm.insertBulk(items);
+        }
+        catch(int)
+        {
+            threw = true;
+        }
+        TCThrowKey::throwsOnDefault = false;
+        TEST_ASSERT(threw);
+        TEST_ASSERT_OP(tm.size(), ==, 2);
+        TEST_ASSERT_OP(tm.getValues().size(), ==, 2);
+        TEST_ASSERT_OP(tm.at(TCThrowKey{1}), ==, 1);
+
+        tm.insertBulk(items);
+        TEST_ASSERT_OP(tm.size(), ==, 4);
+        TEST_ASSERT_OP(tm.at(TCThrowKey{4}), ==, 4);
+    }
+    {
+        using namespace ssvu;
+
+        // Same when inserting a value throws
+        VecMapSoA<int, TCThrowKey> tm;
+        tm[1].x = 1;
+
+        auto threw(false);
+        TCThrowKey::throwsOnDefault = true;
+        try
+        {
+            tm[2];
+        }
+        catch(int)
+        {
+            threw = true;
+        }
+
+        std::vector<std::pair<int, TCThrowKey>> items;
+        items.emplace_back(0, TCThrowKey{0});
+        auto bulkThrew(false);
+        try
+        {
+            tm.insertBulk(items);
+        }
+        catch(int)
+        {
+            bulkThrew = true;
+        }
+        TCThrowKey::throwsOnDefault = false;
+        TEST_ASSERT(threw);
+        TEST_ASSERT(bulkThrew);
+        TEST_ASSERT_OP(tm.size(), ==, 1);
+        TEST_ASSERT_OP(tm.getValues().size(), ==, 1);
+        TEST_ASSERT_OP(tm.at(1).x, ==, 1);
+    }
 }
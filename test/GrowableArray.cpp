@@ -9,6 +9,7 @@
 #include "./utils/test_utils.hpp"
 
 #include <memory>
+#include <string>
 
 
 int main()
@@ -161,4 +162,113 @@ int main()
         TEST_ASSERT_OP(cc, ==, 1);
         TEST_ASSERT_OP(dc, ==, 1);
     }
+
+    {
+        // Trivially relocatable items, grown past the mapping threshold
+        GrowableArray<int> g;
+        TEST_ASSERT(GrowableArray<int>::relocatable);
+
+        g.grow(0, 1000);
+        for(int i = 0; i < 1000; ++i) g[i] = i;
+
+        std::size_t big{Impl::GAMemory::mapThreshold / sizeof(int) * 2};
+        g.grow(1000, big);
+        g[big - 1] = -1;
+        g.grow(big, big * 3);
+        for(int i = 0; i < 1000; ++i) TEST_ASSERT_OP(g[i], ==, i);
+        TEST_ASSERT_OP(g[big - 1], ==, -1);
+        TEST_ASSERT_OP(g.getCapacity(), ==, big * 3);
+
+        g.shrink(1000, 2000);
+        for(int i = 0; i < 1000; ++i) TEST_ASSERT_OP(g[i], ==, i);
+
+        GrowableArray<int> g2{std::move(g)};
+        TEST_ASSERT_OP(g2[999], ==, 999);
+        TEST_ASSERT_OP(g.getCapacity(), ==, 0);
+    }
+
+    {
+        // Relocatable items that are not trivially default constructible
+        // are still constructed
+        struct TestPod
+        {
+            int x{7};
+        };
+
+        GrowableArray<TestPod> g;
+        g.grow(0, 4);
+        g[0].x = 1;
+        g.grow(4, 100);
+        TEST_ASSERT_OP(g[0].x, ==, 1);
+        TEST_ASSERT_OP(g[50].x, ==, 7);
+    }
+
+    {
+        // Other types are moved item by item
+        GrowableArray<std::string> g;
+        TEST_ASSERT(!GrowableArray<std::string>::relocatable);
+
+        g.grow(0, 2);
+        std::string str{"a string that does not fit in the SSO buffer"};
+        g[0] = str;
+        g.grow(2, 50);
+        TEST_ASSERT_OP(g[0], ==, str);
+        TEST_ASSERT(g[49].empty());
+    }
+
+#if defined(SSVU_GROWABLEARRAY_VM)
+    {
+        // Items never move when the array grows
+        GrowableArrayVM<int> g;
+        g.grow(0, 10);
+        for(int i = 0; i < 10; ++i) g[i] = i;
+
+        auto ptr(&g[0]);
+        g.grow(10, 100000);
+        g.grow(100000, 3000000);
+        TEST_ASSERT(&g[0] == ptr);
+        for(int i = 0; i < 10; ++i) TEST_ASSERT_OP(g[i], ==, i);
+
+        g[2999999] = -1;
+        TEST_ASSERT_OP(g[2999999], ==, -1);
+
+        g.shrink(10, 20);
+        TEST_ASSERT(&g[0] == ptr);
+        TEST_ASSERT_OP(g.getCapacity(), ==, 20);
+        g.grow(20, 5000);
+        TEST_ASSERT_OP(g[9], ==, 9);
+    }
+
+    cc = dc = 0;
+
+    {
+        GrowableArrayVMAS<TestItem> g;
+        g.grow(0, 2);
+        g.initAt(0, cc, dc, 0);
+        auto ptr(&g[0]);
+        g.grow(2, 100000);
+        g.initAt(99999, cc, dc, 1);
+        TEST_ASSERT(&g[0] == ptr);
+        TEST_ASSERT_OP(g[0].k, ==, 0);
+        TEST_ASSERT_OP(g[99999].k, ==, 1);
+
+        g.deinitAt(0);
+        g.deinitAt(99999);
+        TEST_ASSERT_OP(cc, ==, 2);
+        TEST_ASSERT_OP(dc, ==, 2);
+    }
+#endif
+
+    {
+        std::string str{"a string that does not fit in the SSO buffer"};
+        GrowableArrayVM<std::string> g;
+        g.grow(0, 1);
+        g[0] = str;
+        g.grow(1, 10000);
+        g[9999] = str;
+        TEST_ASSERT_OP(g[0], ==, str);
+        TEST_ASSERT(g[5000].empty());
+        g.shrink(1, 1);
+        TEST_ASSERT_OP(g[0], ==, str);
+    }
 }
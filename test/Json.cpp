@@ -7,7 +7,10 @@
 #include "./utils/test_utils.hpp"
 
 #include <bitset>
+#include <cstdint>
+#include <limits>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 using namespace std::literals;
@@ -42,6 +45,48 @@ SSVJ_CNV_NAMESPACE()
 }
 SSVJ_CNV_NAMESPACE_END()
 
+namespace
+{
+    enum class BinTestKind : unsigned char
+    {
+        A,
+        B
+    };
+
+    struct BinTestPart
+    {
+        float pos[3]{0.f, 0.f, 0.f};
+        BinTestKind kind{BinTestKind::A};
+        bool alive{true};
+    };
+
+    struct BinTestEntity
+    {
+        int id{0};
+        long int delta{0};
+        std::string name;
+        std::vector<double> samples;
+        std::vector<BinTestPart> parts;
+        std::pair<std::string, unsigned int> tag;
+    };
+
+    struct BinTestEntityV2
+    {
+        int id{0};
+        long int delta{0};
+        std::string name;
+        std::vector<double> samples;
+        std::vector<BinTestPart> parts;
+        std::pair<std::string, unsigned int> tag;
+        int extra{0};
+    };
+}
+
+SSVJ_CNV_ARR(BinTestPart, pos, kind, alive)
+SSVJ_CNV_OBJ_AUTO(BinTestEntity, id, delta, name, samples, parts, tag)
+SSVJ_CNV_OBJ_AUTO(
+    BinTestEntityV2, id, delta, name, samples, parts, tag, extra)
+
 int main()
 {
 
@@ -692,4 +737,257 @@ int main()
             TEST_ASSERT_NS_OP(v.is<Bts>(), ==, true);
         }
     }
+
+    {
+        using namespace ssvu;
+        using namespace ssvu::Json;
+
+        auto schema(Schema::obj()
+                        .req("id", Schema::intg().range(0, 1000))
+                        .req("name", Schema::str().size(1, 8))
+                        .opt("tags", Schema::arr(Schema::str()))
+                        .opt("parent", Schema::obj().req("id", Schema::intg()))
+                        .noExtraKeys()
+                        .compile());
+
+        auto good(fromStr(R"({"id": 5, "name": "abc", "tags": ["x", "y"]})"));
+        TEST_ASSERT(schema.isValid(good));
+        TEST_ASSERT(schema.validate(good).empty());
+
+        auto bad(fromStr(
+            R"({"id": 5.5, "tags": ["x", 1], "parent": {}, "zzz": null})"));
+        TEST_ASSERT(!schema.isValid(bad));
+
+        auto vs(schema.validate(bad));
+        TEST_ASSERT_OP(vs.size(), ==, 5);
+        TEST_ASSERT_OP(vs[0].path, ==, "/id");
+        TEST_ASSERT_OP(vs[1].path, ==, "/");
+        TEST_ASSERT_OP(vs[2].path, ==, "/parent");
+        TEST_ASSERT_OP(vs[3].path, ==, "/tags/1");
+        TEST_ASSERT_OP(vs[4].path, ==, "/");
+
+        // Keys are escaped in paths
+        auto escaped(Schema::obj()
+                         .req("a/b", Schema::intg())
+                         .req("c~d", Schema::obj().req("~/", Schema::intg()))
+                         .compile());
+        auto evs(escaped.validate(
+            fromStr(R"({"a/b": "x", "c~d": {"~/": null}})")));
+        TEST_ASSERT_OP(evs.size(), ==, 2);
+        TEST_ASSERT_OP(evs[0].path, ==, "/a~1b");
+        TEST_ASSERT_OP(evs[1].path, ==, "/c~0d/~0~1");
+
+        auto range(fromStr(R"({"id": 5000, "name": "123456789"})"));
+        TEST_ASSERT_OP(schema.validate(range).size(), ==, 2);
+
+        TEST_ASSERT(!schema.isValid(Val{5}));
+        TEST_ASSERT(Schema::any().compile().isValid(Val{5}));
+        TEST_ASSERT(Schema::str().orNll().compile().isValid(Val{Nll{}}));
+    }
+
+    {
+        using namespace ssvu;
+        using namespace ssvu::Json;
+
+        auto v0(fromStr(R"({"a": [1, 2, {"b": "c"}], "d": 5.5})"));
+        auto v1(fromStr(R"({"d": 5.5, "a": [1, 2, {"b": "c"}]})"));
+        auto v2(fromStr(R"({"a": [1, 2, {"b": "x"}], "d": 5.5})"));
+
+        TEST_ASSERT_OP(v0.getHash(), ==, v1.getHash());
+        TEST_ASSERT_OP(v0.getHash(), !=, v2.getHash());
+        TEST_ASSERT(v0 == v1);
+        TEST_ASSERT(v0 != v2);
+
+        // Copies share the hash, mutations invalidate it
+        auto v3(v0);
+        TEST_ASSERT(v3 == v0);
+        v3["a"][2]["b"] = "x";
+        TEST_ASSERT_OP(v3.getHash(), ==, v2.getHash());
+        TEST_ASSERT(v3 == v2);
+        TEST_ASSERT(v3 != v0);
+
+        // Numbers equal across representations hash equally
+        TEST_ASSERT(Val{5} == Val{5.0});
+        TEST_ASSERT(Val{5.0} == Val{5});
+        TEST_ASSERT(Val{5} == Val{5u});
+        TEST_ASSERT(Val{5} != Val{5.5});
+        TEST_ASSERT(Val{5.5} != Val{5});
+        TEST_ASSERT(Val{-1} != Val{static_cast<IntU>(-1)});
+        TEST_ASSERT_OP(Val{5}.getHash(), ==, Val{5.0}.getHash());
+        TEST_ASSERT_OP(Val{5}.getHash(), ==, Val{5u}.getHash());
+
+        std::unordered_map<Val, int> m;
+        m[v0] = 1;
+        m[v2] = 2;
+        m[v1] = 3;
+        TEST_ASSERT_OP(m.size(), ==, 2);
+        TEST_ASSERT_OP(m[v0], ==, 3);
+
+        std::unordered_map<Val, int, ValHasher> m2;
+        m2[mkArr(1, 2)] = 1;
+        TEST_ASSERT_OP(m2.count(mkArr(1, 2)), ==, 1);
+        TEST_ASSERT_OP(m2.count(mkArr(2, 1)), ==, 0);
+    }
+
+    {
+        using namespace ssvu;
+        using namespace ssvu::Json;
+
+        auto v(fromStr(R"({"a": [1], "b": "a string long enough for the heap",
+            "c": {"d": 5.5, "e": true, "f": null}})"));
+        v["a"].as<Val::Arr>().reserve(16);
+        v["c"].as<Val::Obj>().reserve(16);
+        auto hash(v.getHash());
+
+        auto mu(v.getMemUsage());
+        TEST_ASSERT_OP(mu.obj.count, ==, 2);
+        TEST_ASSERT_OP(mu.arr.count, ==, 1);
+        TEST_ASSERT_OP(mu.str.count, ==, 1);
+        TEST_ASSERT_OP(mu.num.count, ==, 2);
+        TEST_ASSERT_OP(mu.other.count, ==, 2);
+        TEST_ASSERT_OP(mu.num.used, ==, 2 * sizeof(Val));
+        TEST_ASSERT_OP(mu.str.used, >, sizeof(Val));
+        TEST_ASSERT_OP(mu.getTotal().count, ==, 8);
+
+        TEST_ASSERT_OP(mu.obj.getSlack(), >, 0);
+        TEST_ASSERT_OP(mu.arr.getSlack(), >, 0);
+
+        v.shrinkToFit();
+        auto muShrunk(v.getMemUsage());
+        TEST_ASSERT_OP(muShrunk.obj.getSlack(), ==, 0);
+        TEST_ASSERT_OP(muShrunk.arr.getSlack(), ==, 0);
+        TEST_ASSERT_OP(muShrunk.getTotal().used, ==, mu.getTotal().used);
+        TEST_ASSERT_OP(v.getHash(), ==, hash);
+        TEST_ASSERT(v == fromStr(v.getWriteToStr()));
+    }
+
+    {
+        using namespace ssvu;
+        using namespace ssvu::Json;
+
+        std::vector<BinTestEntity> es(3);
+        for(auto i(0u); i < es.size(); ++i)
+        {
+            auto& e(es[i]);
+            e.id = i * 1000;
+            e.delta = -long(i) * 123456789l;
+            e.name = "entity" + std::to_string(i);
+            e.samples = {0.5 * i, -1.25, 1e300};
+            e.parts.resize(i);
+            for(auto& p : e.parts)
+            {
+                p.pos[0] = 1.f;
+                p.pos[2] = float(i);
+                p.kind = BinTestKind::B;
+                p.alive = i % 2 == 0;
+            }
+            e.tag = {"t", i};
+        }
+
+        auto bin(getArchBin(es));
+        auto out(getExtrBin<std::vector<BinTestEntity>>(bin));
+        TEST_ASSERT_OP(out.size(), ==, es.size());
+        for(auto i(0u); i < es.size(); ++i)
+        {
+            TEST_ASSERT_OP(out[i].id, ==, es[i].id);
+            TEST_ASSERT_OP(out[i].delta, ==, es[i].delta);
+            TEST_ASSERT_OP(out[i].name, ==, es[i].name);
+            TEST_ASSERT(out[i].samples == es[i].samples);
+            TEST_ASSERT(out[i].tag == es[i].tag);
+            TEST_ASSERT_OP(out[i].parts.size(), ==, es[i].parts.size());
+            for(auto j(0u); j < es[i].parts.size(); ++j)
+            {
+                const auto& p0(es[i].parts[j]);
+                const auto& p1(out[i].parts[j]);
+                TEST_ASSERT_OP(p1.pos[2], ==, p0.pos[2]);
+                TEST_ASSERT(p1.kind == p0.kind);
+                TEST_ASSERT_OP(p1.alive, ==, p0.alive);
+            }
+        }
+
+        // Same result as the JSON path
+        TEST_ASSERT(getArch(out) == getArch(es));
+
+        // Existing converters can be reused
+        using TestStruct = Json::Impl::__ssvjTestStruct;
+        TestStruct ts;
+        std::get<1>(ts.f4) = 1234;
+        TEST_ASSERT(getExtrBin<TestStruct>(getArchBin(ts)) == ts);
+
+        // Schema hash depends on the field lists
+        TEST_ASSERT_OP(getBinSchemaHash<BinTestEntity>(), !=,
+            getBinSchemaHash<BinTestEntityV2>());
+        TEST_ASSERT_OP(getBinSchemaHash<std::vector<int>>(), !=,
+            getBinSchemaHash<std::vector<unsigned int>>());
+
+        auto throws([](auto&& mF)
+            {
+                try
+                {
+                    mF();
+                }
+                catch(const ReadException&)
+                {
+                    return true;
+                }
+                return false;
+            });
+
+        TEST_ASSERT(throws([&]
+            {
+                getExtrBin<std::vector<BinTestEntityV2>>(bin);
+            }));
+        TEST_ASSERT(throws([&]
+            {
+                getExtrBin<std::vector<BinTestEntity>>(
+                    bin.substr(0, bin.size() - 1));
+            }));
+        TEST_ASSERT(throws([&]
+            {
+                getExtrBin<std::vector<BinTestEntity>>(bin + "x");
+            }));
+
+        // Integers wider than the destination type are rejected
+        std::string ints;
+        Json::Impl::BinWriter w{ints};
+        w.putVarint(255);
+        w.putVarint(256);
+        w.putVarintS(-128);
+        w.putVarintS(-129);
+
+        Json::Impl::BinReader r{ints.data(), ints.size()};
+        unsigned char uc;
+        signed char sc;
+        Json::Impl::BinCodec<unsigned char>::read(r, uc);
+        auto ucThrew(throws([&]
+            {
+                Json::Impl::BinCodec<unsigned char>::read(r, uc);
+            }));
+        Json::Impl::BinCodec<signed char>::read(r, sc);
+        auto scThrew(throws([&]
+            {
+                Json::Impl::BinCodec<signed char>::read(r, sc);
+            }));
+
+        TEST_ASSERT_OP(static_cast<int>(uc), ==, 255);
+        TEST_ASSERT_OP(static_cast<int>(sc), ==, -128);
+        TEST_ASSERT(ucThrew);
+        TEST_ASSERT(scThrew);
+
+        // Varints whose tenth byte holds more than the 64th bit are rejected
+        std::string wide(9, '\xff');
+        std::string max(wide + '\x01');
+        wide += '\x02';
+
+        Json::Impl::BinReader rMax{max.data(), max.size()};
+        Json::Impl::BinReader rWide{wide.data(), wide.size()};
+        auto maxValue(rMax.getVarint());
+        auto wideThrew(throws([&]
+            {
+                rWide.getVarint();
+            }));
+
+        TEST_ASSERT(maxValue == std::numeric_limits<std::uint64_t>::max());
+        TEST_ASSERT(wideThrew);
+    }
 }
@@ -2,12 +2,21 @@
 // License: Academic Free License ("AFL") v. 3.0
 // AFL License page: http://opensource.org/licenses/AFL-3.0
 
-
 #include "SSVUtils/Core/Core.hpp"
 
 #include "SSVUtils/MemoryManager/MemoryManager.hpp"
 
 #include "./utils/test_utils.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <list>
+#include <map>
+#include <memory_resource>
+#include <string>
+#include <thread>
+#include <vector>
+
 int main()
 {
     {
@@ -483,4 +492,1403 @@ int main()
         TEST_ASSERT_OP(cc, ==, 7);
         TEST_ASSERT_OP(dc, ==, 7);
     }
-}
\ No newline at end of file
+    {
+        struct TMMSlabItem
+        {
+            long int id;
+            inline TMMSlabItem(long int mId) : id{mId} {}
+        };
+
+        ssvu::MonoRecycler<TMMSlabItem> mr;
+
+        // Objects are carved out of the same slab, contiguously
+        auto i1 = mr.create(1);
+        auto i2 = mr.create(2);
+        TEST_ASSERT_OP(reinterpret_cast<char*>(i2.get()) -
+                           reinterpret_cast<char*>(i1.get()),
+            ==, sizeof(TMMSlabItem));
+
+        // Destroyed objects are recycled
+        auto addr(i1.get());
+        i1.reset();
+        auto i3 = mr.create(3);
+        TEST_ASSERT(i3.get() == addr);
+        TEST_ASSERT_OP(i3->id, ==, 3);
+
+        ssvu::MonoManager<TMMSlabItem> mm;
+        for(auto i(0l); i < 100000; ++i) mm.create(i);
+        mm.refresh();
+        TEST_ASSERT_OP(mm.size(), ==, 100000);
+
+        auto sum(0l);
+        for(auto& i : mm)
+        {
+            sum += i->id;
+            if(i->id % 2 == 0) mm.del(*i);
+        }
+        TEST_ASSERT_OP(sum, ==, 99999l * 100000l / 2);
+
+        mm.refresh();
+        TEST_ASSERT_OP(mm.size(), ==, 50000);
+        for(auto& i : mm) TEST_ASSERT_OP(i->id % 2, ==, 1);
+    }
+    {
+        static std::atomic<int> cc{0}, dc{0};
+
+        struct TMMCItem
+        {
+            long int id, pad;
+            inline TMMCItem(long int mId) : id{mId}, pad{0} { ++cc; }
+            inline virtual ~TMMCItem() { ++dc; }
+        };
+        struct TMMCItemB : public TMMCItem
+        {
+            char stuff[40];
+            using TMMCItem::TMMCItem;
+        };
+
+        constexpr auto threadCount(4), itemCount(20000);
+
+        {
+            ssvu::ConcurrentMonoRecycler<TMMCItem> mr;
+            ssvu::ConcurrentPolyRecycler<TMMCItem> pr;
+            using PtrType = decltype(mr.create(0));
+            using PolyPtrType = decltype(pr.create(0));
+
+            // Every thread creates objects and hands half of them to the
+            // next thread, which destroys them (cross-thread free)
+            std::vector<std::vector<PtrType>> handoff(threadCount);
+            std::vector<std::vector<PolyPtrType>> polyHandoff(threadCount);
+            std::atomic<int> ready{0};
+            std::atomic<bool> ok{true};
+
+            std::vector<std::thread> threads;
+            for(auto t(0); t < threadCount; ++t)
+                threads.emplace_back([&, t]
+                    {
+                        std::vector<PtrType> mine;
+                        std::vector<PolyPtrType> polyMine;
+                        for(auto i(0); i < itemCount; ++i)
+                        {
+                            mine.emplace_back(mr.create(t * itemCount + i));
+                            if(i % 2 == 0)
+                                polyMine.emplace_back(pr.create(i));
+                            else
+                                polyMine.emplace_back(
+                                    pr.create<TMMCItemB>(i));
+                        }
+
+                        for(auto i(0); i < itemCount; ++i)
+                            if(mine[i]->id != t * itemCount + i)
+                                ok = false;
+
+                        for(auto i(0); i < itemCount / 2; ++i)
+                        {
+                            handoff[t].emplace_back(std::move(mine.back()));
+                            mine.pop_back();
+                        }
+                        polyHandoff[t] = std::move(polyMine);
+
+                        ++ready;
+                        while(ready != threadCount) std::this_thread::yield();
+
+                        // Destroy objects created by another thread
+                        handoff[(t + 1) % threadCount].clear();
+                        polyHandoff[(t + 1) % threadCount].clear();
+
+                        // Recycle memory freed by this thread
+                        for(auto i(0); i < itemCount / 2; ++i)
+                            mine.emplace_back(mr.create(i));
+                        for(auto i(0); i < itemCount; ++i)
+                            if(mine[i]->id != (i < itemCount / 2
+                                                      ? t * itemCount + i
+                                                      : i - itemCount / 2))
+                                ok = false;
+                    });
+
+            for(auto& t : threads) t.join();
+            TEST_ASSERT(ok.load());
+            TEST_ASSERT_OP(cc.load(), ==, dc.load());
+        }
+
+        TEST_ASSERT_OP(cc.load(), ==, dc.load());
+        TEST_ASSERT_OP(cc.load(), ==, threadCount * itemCount * 5 / 2);
+    }
+    {
+        using namespace ssvu::Impl;
+
+        // Batches can only be pushed while descriptors are available
+        ConcurrentBatchPool pool;
+        std::vector<ConcurrentFreeNode> nodes(1000);
+        auto fill([&]
+            {
+                std::size_t result{0};
+                while(result < nodes.size() && pool.push(&nodes[result]))
+                    ++result;
+                return result;
+            });
+
+        TEST_ASSERT_OP(fill(), ==, 0);
+
+        pool.reserve(1);
+        auto pushed(fill());
+        TEST_ASSERT_OP(pushed, >, 0);
+        TEST_ASSERT_OP(pushed, <, nodes.size());
+
+        for(auto i(pushed); i-- > 0;)
+        {
+            auto batch(pool.pop());
+            TEST_ASSERT(batch == &nodes[i]);
+        }
+        auto last(pool.pop());
+        TEST_ASSERT(last == nullptr);
+
+        // Descriptors are reused, and more can be reserved
+        pool.reserve(pushed + 1);
+        auto pushedMore(fill());
+        TEST_ASSERT_OP(pushedMore, >, pushed);
+    }
+    {
+        using namespace ssvu::Impl;
+
+        TEST_ASSERT_OP(getSizeClassIdx(1), ==, 0);
+        TEST_ASSERT_OP(getSizeClassIdx(16), ==, 0);
+        TEST_ASSERT_OP(getSizeClassIdx(17), ==, 1);
+        TEST_ASSERT_OP(getSizeClassSize(getSizeClassIdx(256)), ==, 256);
+        TEST_ASSERT_OP(getSizeClassSize(getSizeClassIdx(257)), ==, 320);
+        TEST_ASSERT_OP(getSizeClassSize(getSizeClassIdx(1000)), ==, 1024);
+        TEST_ASSERT_OP(getSizeClassSize(getSizeClassIdx(1025)), ==, 1280);
+
+        for(auto sz(1u); sz <= sizeClassMax; ++sz)
+        {
+            auto idx(getSizeClassIdx(sz));
+            TEST_ASSERT_OP(getSizeClassSize(idx), >=, sz);
+            if(idx > 0) TEST_ASSERT_OP(getSizeClassSize(idx - 1), <, sz);
+        }
+
+        struct TMMSCItem
+        {
+            long int id;
+            inline TMMSCItem(long int mId) : id{mId} {}
+            inline virtual ~TMMSCItem() {}
+        };
+        struct TMMSCItemA : public TMMSCItem
+        {
+            char stuff[4];
+            using TMMSCItem::TMMSCItem;
+        };
+        struct TMMSCItemB : public TMMSCItem
+        {
+            char stuff[12];
+            using TMMSCItem::TMMSCItem;
+        };
+        struct TMMSCItemBig : public TMMSCItem
+        {
+            char stuff[sizeClassMax];
+            using TMMSCItem::TMMSCItem;
+        };
+
+        SSVU_ASSERT_STATIC_NM(sizeof(TMMSCItemA) != sizeof(TMMSCItemB));
+        SSVU_ASSERT_STATIC_NM(getSizeClassIdx(sizeof(TMMSCItemA)) ==
+                              getSizeClassIdx(sizeof(TMMSCItemB)));
+
+        ssvu::PolyRecycler<TMMSCItem> pr;
+
+        // Types of the same size class share memory
+        auto a(pr.create<TMMSCItemA>(1));
+        auto addr(static_cast<void*>(a.get()));
+        a.reset();
+        auto b(pr.create<TMMSCItemB>(2));
+        TEST_ASSERT(static_cast<void*>(b.get()) == addr);
+        TEST_ASSERT_OP(b->id, ==, 2);
+
+        auto big(pr.create<TMMSCItemBig>(3));
+        TEST_ASSERT_OP(big->id, ==, 3);
+
+        ssvu::ConcurrentPolyRecycler<TMMSCItem> cpr;
+        auto ca(cpr.create<TMMSCItemA>(4));
+        auto cb(cpr.create<TMMSCItemB>(5));
+        auto cbig(cpr.create<TMMSCItemBig>(6));
+        TEST_ASSERT_OP(ca->id + cb->id + cbig->id, ==, 15);
+    }
+    {
+        static int cc{0}, dc{0};
+
+        struct TMMSlotItem
+        {
+            int id;
+            std::string name;
+            bool moved{false};
+
+            inline TMMSlotItem(int mId) : id{mId}, name(std::to_string(mId))
+            {
+                ++cc;
+            }
+            inline TMMSlotItem(TMMSlotItem&& mX) noexcept
+                : id{mX.id}, name{std::move(mX.name)}
+            {
+                mX.moved = true;
+            }
+            inline TMMSlotItem& operator=(TMMSlotItem&& mX) noexcept
+            {
+                id = mX.id;
+                name = std::move(mX.name);
+                moved = false;
+                mX.moved = true;
+                return *this;
+            }
+            inline ~TMMSlotItem()
+            {
+                if(!moved) ++dc;
+            }
+        };
+
+        {
+            ssvu::SlotManager<TMMSlotItem> sm;
+            std::vector<ssvu::SlotHandle> hs;
+
+            for(auto i(0); i < 100; ++i) hs.emplace_back(sm.create(i));
+            TEST_ASSERT_OP(sm.size(), ==, 0);
+
+            sm.refresh();
+            TEST_ASSERT_OP(sm.size(), ==, 100);
+
+            for(auto i(0); i < 100; ++i)
+            {
+                TEST_ASSERT(sm.isAlive(hs[i]));
+                TEST_ASSERT_OP(sm[hs[i]].id, ==, i);
+                TEST_ASSERT(sm.getHandle(sm[hs[i]]) == hs[i]);
+            }
+
+            // Delete even objects, by handle or by reference
+            for(auto i(0); i < 100; i += 2)
+                if(i % 4 == 0)
+                    sm.del(hs[i]);
+                else
+                    sm.del(sm[hs[i]]);
+
+            TEST_ASSERT(sm.isValid(hs[0]) && !sm.isAlive(hs[0]));
+            TEST_ASSERT_OP(sm.size(), ==, 100);
+
+            sm.refresh();
+            TEST_ASSERT_OP(sm.size(), ==, 50);
+            TEST_ASSERT_OP(cc - dc, ==, 50);
+
+            // Handles survive the compaction
+            for(auto i(0); i < 100; ++i)
+            {
+                TEST_ASSERT_OP(sm.isValid(hs[i]), ==, i % 2 == 1);
+                if(i % 2 == 0)
+                    TEST_ASSERT(sm.get(hs[i]) == nullptr);
+                else
+                {
+                    TEST_ASSERT_OP(sm[hs[i]].id, ==, i);
+                    TEST_ASSERT_OP(sm[hs[i]].name, ==, std::to_string(i));
+                }
+            }
+
+            // Dense iteration only sees alive objects
+            auto sum(0);
+            for(auto& x : sm) sum += x.id;
+            TEST_ASSERT_OP(sum, ==, 50 * 50);
+
+            // Slots are reused with a new generation
+            auto h(sm.create(1000));
+            auto& stale(*std::find_if(std::begin(hs), std::end(hs),
+                [&h](const auto& mH) { return mH.idx == h.idx; }));
+            TEST_ASSERT(stale.gen != h.gen);
+            TEST_ASSERT(!sm.isValid(stale) && sm.isValid(h));
+            sm.refresh();
+            TEST_ASSERT_OP(sm[h].id, ==, 1000);
+            TEST_ASSERT_OP(sm.size(), ==, 51);
+        }
+
+        TEST_ASSERT_OP(cc, ==, 101);
+        TEST_ASSERT_OP(dc, ==, 101);
+    }
+    {
+        static std::atomic<int> cc{0}, dc{0};
+
+        struct TMMParItem
+        {
+            int id;
+            long int value{0};
+
+            inline TMMParItem(int mId) : id{mId}
+            {
+                ++cc;
+            }
+            inline virtual ~TMMParItem()
+            {
+                ++dc;
+            }
+        };
+        struct TMMParItemB : public TMMParItem
+        {
+            char stuff[40];
+            using TMMParItem::TMMParItem;
+        };
+
+        auto runTest([](auto& mM, int mCount, int mDeadPercent, bool mParallel)
+            {
+                cc = dc = 0;
+
+                for(auto i(0); i < mCount; ++i)
+                    if(i % 3 == 0)
+                        mM.template create<TMMParItemB>(i);
+                    else
+                        mM.create(i);
+
+                mM.refreshParallel();
+                TEST_ASSERT_OP(int(mM.size()), ==, mCount);
+
+                mM.forEachParallel([&mM, mDeadPercent](auto& mX)
+                    {
+                        mX.value = mX.id * 2;
+                        if(mX.id % 100 < mDeadPercent) mM.del(mX);
+                    });
+
+                mM.refreshParallel();
+
+                auto alive(0), lastId(-1);
+                auto ok(true);
+                for(auto& x : mM)
+                {
+                    ok = ok && (!mParallel || x->id > lastId) &&
+                         x->value == x->id * 2 &&
+                         x->id % 100 >= mDeadPercent;
+                    lastId = x->id;
+                    ++alive;
+                }
+
+                // Order of alive objects is preserved by the parallel path
+                TEST_ASSERT(ok);
+                TEST_ASSERT_OP(int(mM.size()), ==, alive);
+                TEST_ASSERT_OP(alive, ==, mCount / 100 * (100 - mDeadPercent));
+                TEST_ASSERT_OP(cc.load() - dc.load(), ==, alive);
+
+                // Memory of dead objects is recycled
+                for(auto i(0); i < mCount - alive; ++i) mM.create(mCount + i);
+                mM.refresh();
+                TEST_ASSERT_OP(int(mM.size()), ==, mCount);
+
+                mM.clear();
+                TEST_ASSERT_OP(cc.load(), ==, dc.load());
+            });
+
+        for(auto deadPercent : {1, 50, 99})
+        {
+            ssvu::PolyManager<TMMParItem> pm;
+            runTest(pm, 50000, deadPercent, true);
+        }
+
+        {
+            // Small managers use the serial `refresh`
+            ssvu::PolyManager<TMMParItem> pm;
+            runTest(pm, 100, 50, false);
+        }
+    }
+    {
+        static int cc{0}, dc{0};
+
+        struct TMMAlignItem
+        {
+            int id;
+            inline TMMAlignItem(int mId) : id{mId}
+            {
+                ++cc;
+            }
+            inline virtual ~TMMAlignItem()
+            {
+                ++dc;
+            }
+        };
+        struct alignas(32) TMMAlignItem32 : public TMMAlignItem
+        {
+            char data[20];
+            using TMMAlignItem::TMMAlignItem;
+        };
+        struct alignas(64) TMMAlignItem64 : public TMMAlignItem
+        {
+            char data[70];
+            using TMMAlignItem::TMMAlignItem;
+        };
+
+        auto isAligned([](const void* mPtr, std::size_t mAlign)
+            {
+                return reinterpret_cast<std::uintptr_t>(mPtr) % mAlign == 0;
+            });
+
+        auto runTest([&isAligned](auto& mM)
+            {
+                cc = dc = 0;
+
+                auto ok(true);
+                for(auto r(0); r < 3; ++r)
+                {
+                    for(auto i(0); i < 60; ++i)
+                    {
+                        if(i % 3 == 0)
+                            mM.create(i);
+                        else if(i % 3 == 1)
+                            mM.template create<TMMAlignItem32>(i);
+                        else
+                            mM.template create<TMMAlignItem64>(i);
+                    }
+
+                    mM.refresh();
+                    for(auto& x : mM)
+                    {
+                        auto align(x->id % 3 == 0
+                                       ? alignof(TMMAlignItem)
+                                       : x->id % 3 == 1 ? 32 : 64);
+                        ok = ok && isAligned(x.get(), align);
+
+                        // Delete half of the objects of every type
+                        if(x->id % 2 == 0) mM.del(*x);
+                    }
+
+                    mM.refresh();
+                    for(auto& x : mM) ok = ok && x->id % 2 == 1;
+                }
+
+                TEST_ASSERT(ok);
+                TEST_ASSERT_OP(int(mM.size()), ==, 3 * 30);
+                TEST_ASSERT_OP(cc - dc, ==, int(mM.size()));
+
+                mM.clear();
+                TEST_ASSERT_OP(cc, ==, dc);
+            });
+
+        {
+            ssvu::PolyManager<TMMAlignItem> pm;
+            runTest(pm);
+        }
+        {
+            ssvu::BitsetPolyManager<TMMAlignItem> pm;
+            runTest(pm);
+        }
+        {
+            ssvu::PaddedPolyManager<TMMAlignItem> pm;
+            runTest(pm);
+
+            // Padded objects never share a cache line
+            std::vector<TMMAlignItem*> ptrs;
+            for(auto i(0); i < 20; ++i) ptrs.emplace_back(&pm.create(i));
+            std::sort(std::begin(ptrs), std::end(ptrs));
+
+            auto ok(true);
+            for(auto i(0u); i < ptrs.size(); ++i)
+            {
+                ok = ok && isAligned(ptrs[i], 64);
+                if(i > 0)
+                    ok = ok && reinterpret_cast<char*>(ptrs[i]) -
+                                       reinterpret_cast<char*>(ptrs[i - 1]) >=
+                                   64;
+            }
+            TEST_ASSERT(ok);
+        }
+        {
+            ssvu::PolyRecycler<TMMAlignItem> pr;
+            auto p0(pr.template create<TMMAlignItem64>(0));
+            auto p1(pr.template create<TMMAlignItem32>(1));
+            TEST_ASSERT(isAligned(p0.get(), 64));
+            TEST_ASSERT(isAligned(p1.get(), 32));
+
+            // Memory of over-aligned objects is recycled for the same type
+            auto addr(p0.get());
+            p0.reset();
+            auto p2(pr.template create<TMMAlignItem64>(2));
+            TEST_ASSERT(p2.get() == addr);
+        }
+    }
+    {
+        static int cc{0}, dc{0};
+
+        struct TMMBitItem
+        {
+            int id;
+            long int value{0};
+            inline TMMBitItem(int mId) : id{mId}
+            {
+                ++cc;
+            }
+            inline ~TMMBitItem()
+            {
+                ++dc;
+            }
+        };
+
+        ssvu::BitsetMonoManager<TMMBitItem> mm;
+
+        // Crosses several bitset words and capacity growths
+        for(auto i(0); i < 1000; ++i) mm.create(i);
+        mm.refresh();
+        TEST_ASSERT_OP(mm.size(), ==, 1000);
+
+        for(auto& x : mm)
+            if(x->id % 7 != 0) mm.del(*x);
+
+        // Objects created before the refresh are not affected by `del`
+        for(auto i(1000); i < 1100; ++i) mm.create(i);
+        mm.refresh();
+
+        auto ok(true);
+        for(auto& x : mm) ok = ok && (x->id % 7 == 0 || x->id >= 1000);
+        TEST_ASSERT(ok);
+        TEST_ASSERT_OP(mm.size(), ==, 143 + 100);
+        TEST_ASSERT_OP(cc - dc, ==, 143 + 100);
+
+        // Positions are kept up to date across refreshes
+        for(auto& x : mm)
+            if(x->id >= 1000) mm.del(*x);
+        mm.refresh();
+        TEST_ASSERT_OP(mm.size(), ==, 143);
+
+        ok = true;
+        for(auto& x : mm) ok = ok && x->id % 7 == 0 && x->id < 1000;
+        TEST_ASSERT(ok);
+
+        mm.clear();
+        TEST_ASSERT_OP(cc, ==, dc);
+
+        for(auto i(0); i < 10; ++i) mm.create(i);
+        mm.refresh();
+        TEST_ASSERT_OP(mm.size(), ==, 10);
+    }
+    {
+        static std::atomic<int> cc{0}, dc{0};
+
+        struct TMMBitParItem
+        {
+            int id;
+            long int value{0};
+            inline TMMBitParItem(int mId) : id{mId}
+            {
+                ++cc;
+            }
+            inline ~TMMBitParItem()
+            {
+                ++dc;
+            }
+        };
+
+        ssvu::BitsetMonoManager<TMMBitParItem> mm;
+        for(auto i(0); i < 20000; ++i) mm.create(i);
+        mm.refreshParallel();
+
+        // Concurrent deletions of objects sharing the same bitset words
+        mm.forEachParallel([&mm](auto& mX)
+            {
+                if(mX.id % 3 != 0) mm.del(mX);
+            });
+        mm.refreshParallel();
+
+        auto ok(true);
+        auto lastId(-1);
+        for(auto& x : mm)
+        {
+            ok = ok && x->id % 3 == 0 && x->id > lastId;
+            lastId = x->id;
+        }
+        TEST_ASSERT(ok);
+        TEST_ASSERT_OP(mm.size(), ==, 6667);
+        TEST_ASSERT_OP(cc.load() - dc.load(), ==, 6667);
+
+        // Flags are still correct after the parallel compaction
+        for(auto& x : mm)
+            if(x->id % 2 == 0) mm.del(*x);
+        mm.refresh();
+        TEST_ASSERT_OP(mm.size(), ==, 3333);
+
+        mm.clear();
+        TEST_ASSERT_OP(cc.load(), ==, dc.load());
+    }
+    {
+        struct TMMTrimItem
+        {
+            long int id;
+            char data[24];
+            inline TMMTrimItem(long int mId) : id{mId} {}
+        };
+
+        {
+            ssvu::MonoRecycler<TMMTrimItem> mr;
+            std::vector<ssvu::MonoRecycler<TMMTrimItem>::PtrType> ptrs;
+            for(auto i(0); i < 20000; ++i) ptrs.emplace_back(mr.create(i));
+
+            // Every slab has objects in use: nothing can be released
+            for(auto i(0u); i < ptrs.size(); ++i)
+                if(i % 50 != 0) ptrs[i].reset();
+
+            TEST_ASSERT_OP(mr.shrinkToFit(), ==, 0);
+
+            // Only objects in the same slab as the remaining ones are kept
+            for(auto i(0u); i < ptrs.size(); ++i)
+                if(i > 100) ptrs[i].reset();
+
+            TEST_ASSERT_OP(mr.trim(20000), ==, 0);
+            TEST_ASSERT_OP(mr.trim(0), >, 0);
+            TEST_ASSERT_OP(ptrs[100]->id, ==, 100);
+
+            ptrs.clear();
+            TEST_ASSERT_OP(mr.shrinkToFit(), >, 0);
+            TEST_ASSERT_OP(mr.shrinkToFit(), ==, 0);
+
+            // Memory is allocated again when required
+            auto p(mr.create(5));
+            TEST_ASSERT_OP(p->id, ==, 5);
+        }
+
+        {
+            ssvu::PolyManager<TMMTrimItem> mm;
+            for(auto i(0); i < 100000; ++i) mm.create(i);
+            mm.refresh();
+            for(auto& x : mm) mm.del(*x);
+            mm.refresh();
+
+            TEST_ASSERT_OP(mm.shrinkToFit(), >, 100000 * sizeof(TMMTrimItem));
+            TEST_ASSERT_OP(mm.shrinkToFit(), ==, 0);
+
+            for(auto i(0); i < 100; ++i) mm.create(i);
+            mm.refresh();
+            TEST_ASSERT_OP(mm.size(), ==, 100);
+        }
+
+        {
+            ssvu::PolyRecVector<TMMTrimItem> rv;
+            for(auto i(0); i < 10000; ++i) rv.create(i);
+            rv.clear();
+            TEST_ASSERT_OP(rv.shrinkToFit(), >, 0);
+            TEST_ASSERT_OP(rv.capacity(), ==, 0);
+        }
+
+        {
+            ssvu::ConcurrentMonoRecycler<TMMTrimItem> cr;
+            std::vector<ssvu::ConcurrentMonoRecycler<TMMTrimItem>::PtrType>
+                ptrs;
+
+            std::thread t([&cr, &ptrs]
+                {
+                    for(auto i(0); i < 5000; ++i)
+                        ptrs.emplace_back(cr.create(i));
+                });
+            t.join();
+
+            // Objects are recycled in this thread's cache
+            ptrs.clear();
+            TEST_ASSERT_OP(cr.shrinkToFit(), >, 0);
+
+            for(auto i(0); i < 100; ++i) ptrs.emplace_back(cr.create(i));
+            TEST_ASSERT_OP(ptrs[99]->id, ==, 99);
+        }
+    }
+    {
+        static int cc{0}, dc{0};
+
+        struct TMMBulkItem
+        {
+            long int id, value;
+            inline TMMBulkItem(long int mId, long int mValue)
+                : id{mId}, value{mValue}
+            {
+                ++cc;
+            }
+            inline virtual ~TMMBulkItem()
+            {
+                ++dc;
+            }
+        };
+        struct TMMBulkItemB : public TMMBulkItem
+        {
+            char data[40];
+            using TMMBulkItem::TMMBulkItem;
+        };
+
+        auto runTest([](auto& mM)
+            {
+                cc = dc = 0;
+
+                mM.createN(10, 1, 5);
+                mM.template createRange<TMMBulkItemB>(5000,
+                    [](auto& mX, std::size_t mI) { mX.id = mI; }, -1, 7);
+                mM.refresh();
+                TEST_ASSERT_OP(mM.size(), ==, 5010);
+                TEST_ASSERT_OP(cc, ==, 5010);
+
+                auto ok(true);
+                auto sum(0l);
+                for(auto& x : mM)
+                {
+                    ok = ok && (x->value == 5 || x->value == 7);
+                    if(x->value == 7) sum += x->id;
+                }
+                TEST_ASSERT(ok);
+                TEST_ASSERT_OP(sum, ==, 4999l * 5000l / 2);
+
+                mM.delAll([](const auto& mX) { return mX.id % 2 == 0; });
+                mM.refresh();
+                TEST_ASSERT_OP(mM.size(), ==, 2510);
+                TEST_ASSERT_OP(dc, ==, 2500);
+
+                ok = true;
+                for(auto& x : mM) ok = ok && x->id % 2 == 1;
+                TEST_ASSERT(ok);
+
+                mM.template createN<TMMBulkItemB>(2510, 0, 0);
+                mM.createN(100000, 0, 0);
+
+                mM.refresh();
+                TEST_ASSERT_OP(mM.size(), ==, 2510 + 2510 + 100000);
+
+                mM.clear();
+                TEST_ASSERT_OP(cc, ==, dc);
+            });
+
+        {
+            ssvu::PolyManager<TMMBulkItem> pm;
+            runTest(pm);
+        }
+        {
+            ssvu::BitsetPolyManager<TMMBulkItem> pm;
+            runTest(pm);
+        }
+
+        {
+            cc = dc = 0;
+            ssvu::PolyRecycler<TMMBulkItem> pr;
+            std::vector<ssvu::PolyRecycler<TMMBulkItem>::PtrType> ptrs;
+            pr.template createN<TMMBulkItemB>(
+                100, [&ptrs](auto&& mPtr) { ptrs.emplace_back(FWD(mPtr)); },
+                1, 2);
+            TEST_ASSERT_OP(ptrs.size(), ==, 100);
+            TEST_ASSERT_OP(ptrs[99]->value, ==, 2);
+
+            ssvu::MonoRecVector<TMMBulkItem> rv;
+            rv.createN(50, 3, 4);
+            TEST_ASSERT_OP(rv.size(), ==, 50);
+            TEST_ASSERT_OP(rv[49]->id, ==, 3);
+        }
+        TEST_ASSERT_OP(cc, ==, dc);
+    }
+    {
+        struct TMMThrowItem
+        {
+            long int id, pad;
+            inline TMMThrowItem(long int mId, bool mThrow) : id{mId}, pad{0}
+            {
+                if(mThrow) throw mId;
+            }
+        };
+
+        auto throws([](auto&& mF)
+            {
+                try
+                {
+                    mF();
+                }
+                catch(long int)
+                {
+                    return true;
+                }
+                return false;
+            });
+
+        // Memory of objects whose constructor throws is recycled
+        ssvu::MonoRecycler<TMMThrowItem> mr;
+        auto first(mr.create(0, false).get());
+
+        auto threw(throws([&]
+            {
+                mr.createN(1, [](auto&&) {}, 1, true);
+            }));
+        TEST_ASSERT(threw);
+        auto p(mr.create(2, false));
+        TEST_ASSERT(p.get() == first);
+        p.reset();
+
+        threw = throws([&]
+            {
+                mr.create(3, true);
+            });
+        TEST_ASSERT(threw);
+        p = mr.create(4, false);
+        TEST_ASSERT(p.get() == first);
+
+        ssvu::ConcurrentMonoRecycler<TMMThrowItem> cr;
+        auto cFirst(cr.create(8, false).get());
+        threw = throws([&]
+            {
+                cr.create(9, true);
+            });
+        TEST_ASSERT(threw);
+        auto c(cr.create(10, false));
+        TEST_ASSERT(c.get() == cFirst);
+
+        // Slots of objects whose constructor throws are not lost
+        ssvu::SlotManager<TMMThrowItem> sm;
+        auto h(sm.create(5, false));
+        sm.del(h);
+        sm.refresh();
+
+        threw = throws([&]
+            {
+                sm.create(6, true);
+            });
+        TEST_ASSERT(threw);
+        auto h2(sm.create(7, false));
+        sm.refresh();
+        TEST_ASSERT_OP(h2.idx, ==, h.idx);
+        TEST_ASSERT_OP(sm.size(), ==, 1);
+        TEST_ASSERT_OP(sm[h2].id, ==, 7);
+    }
+    {
+        static int cc{0}, dc{0};
+
+        struct TMMTypeItem
+        {
+            int id;
+            inline TMMTypeItem(int mId) : id{mId}
+            {
+                ++cc;
+            }
+            inline virtual ~TMMTypeItem()
+            {
+                ++dc;
+            }
+            inline virtual int getKind() const
+            {
+                return 0;
+            }
+        };
+        struct TMMTypeItemB : public TMMTypeItem
+        {
+            char data[16];
+            using TMMTypeItem::TMMTypeItem;
+            inline int getKind() const override
+            {
+                return 1;
+            }
+        };
+        struct TMMTypeItemC : public TMMTypeItem
+        {
+            char data[48];
+            using TMMTypeItem::TMMTypeItem;
+            inline int getKind() const override
+            {
+                return 2;
+            }
+        };
+
+        auto countKindChanges([](auto& mM)
+            {
+                auto changes(0), lastKind(-1);
+                for(auto& x : mM)
+                {
+                    if(x->getKind() != lastKind) ++changes;
+                    lastKind = x->getKind();
+                }
+                return changes;
+            });
+
+        auto runTest([&countKindChanges](auto& mM, bool mGrouped)
+            {
+                cc = dc = 0;
+                auto create([&mM](int mI)
+                    {
+                        if(mI % 3 == 0)
+                            mM.create(mI);
+                        else if(mI % 3 == 1)
+                            mM.template create<TMMTypeItemB>(mI);
+                        else
+                            mM.template create<TMMTypeItemC>(mI);
+                    });
+
+                mM.setGroupByType(mGrouped);
+                for(auto i(0); i < 300; ++i) create(i);
+                mM.refresh();
+
+                for(auto r(0); r < 3; ++r)
+                {
+                    if(mGrouped) TEST_ASSERT_OP(countKindChanges(mM), ==, 3);
+
+                    mM.delAll([r](auto& mX) { return mX.id % 4 == r; });
+                    for(auto i(0); i < 30; ++i) create(1000 + i);
+                    mM.refresh();
+                }
+
+                if(mGrouped) TEST_ASSERT_OP(countKindChanges(mM), ==, 3);
+
+                // Objects of the listed types are passed with their type
+                int expected[3]{0, 0, 0}, counts[3]{0, 0, 0};
+                for(auto& x : mM) ++expected[x->getKind()];
+
+                mM.template forEachByType<TMMTypeItemB, TMMTypeItemC>(
+                    [&counts](auto& mX)
+                    {
+                        using T = std::decay_t<decltype(mX)>;
+                        if constexpr(std::is_same_v<T, TMMTypeItemB>)
+                            counts[1] += mX.getKind() == 1;
+                        else if constexpr(std::is_same_v<T, TMMTypeItemC>)
+                            counts[2] += mX.getKind() == 2;
+                        else
+                            counts[0] += mX.getKind() == 0;
+                    });
+
+                TEST_ASSERT_OP(counts[0], ==, expected[0]);
+                TEST_ASSERT_OP(counts[1], ==, expected[1]);
+                TEST_ASSERT_OP(counts[2], ==, expected[2]);
+                TEST_ASSERT_OP(counts[0] + counts[1] + counts[2], ==,
+                    int(mM.size()));
+
+                // Deletions still target the right objects after grouping
+                mM.delAll([](auto& mX) { return mX.getKind() == 1; });
+                mM.refresh();
+                TEST_ASSERT_OP(
+                    int(mM.size()), ==, expected[0] + expected[2]);
+                if(mGrouped) TEST_ASSERT_OP(countKindChanges(mM), ==, 2);
+
+                mM.clear();
+                TEST_ASSERT_OP(cc, ==, dc);
+            });
+
+        for(auto grouped : {true, false})
+        {
+            {
+                ssvu::PolyManager<TMMTypeItem> pm;
+                runTest(pm, grouped);
+            }
+            {
+                ssvu::BitsetPolyManager<TMMTypeItem> pm;
+                runTest(pm, grouped);
+            }
+        }
+    }
+    {
+        // Counts the allocations forwarded to the upstream resource
+        struct TMMUpstream : public std::pmr::memory_resource
+        {
+            int count{0};
+
+            inline void* do_allocate(std::size_t mBytes, std::size_t mAlign)
+                override
+            {
+                ++count;
+                return std::pmr::new_delete_resource()->allocate(
+                    mBytes, mAlign);
+            }
+            inline void do_deallocate(void* mPtr, std::size_t mBytes,
+                std::size_t mAlign) override
+            {
+                --count;
+                std::pmr::new_delete_resource()->deallocate(
+                    mPtr, mBytes, mAlign);
+            }
+            inline bool do_is_equal(
+                const std::pmr::memory_resource& mX) const noexcept override
+            {
+                return this == &mX;
+            }
+        };
+
+        TMMUpstream upstream;
+        ssvu::MMPoolResource res{&upstream};
+
+        {
+            std::pmr::list<int> l{&res};
+            for(auto i(0); i < 1000; ++i) l.emplace_back(i);
+
+            std::pmr::map<int, std::pmr::string> m{&res};
+            for(auto i(0); i < 200; ++i)
+                m.emplace(i, "a string that does not fit in the SSO buffer");
+
+            TEST_ASSERT_OP(upstream.count, ==, 0);
+
+            // Deallocated nodes are reused
+            for(auto r(0); r < 10; ++r)
+            {
+                l.clear();
+                for(auto i(0); i < 1000; ++i) l.emplace_back(i);
+            }
+
+            TEST_ASSERT_OP(upstream.count, ==, 0);
+            TEST_ASSERT_OP(l.back(), ==, 999);
+            TEST_ASSERT(m[199].size() > 40);
+        }
+
+        {
+            // Big or over-aligned allocations use the upstream resource
+            std::pmr::vector<char> v{&res};
+            v.resize(1024 * 1024);
+            TEST_ASSERT_OP(upstream.count, ==, 1);
+
+            auto p(res.allocate(64, 64));
+            TEST_ASSERT_OP(upstream.count, ==, 2);
+            TEST_ASSERT(reinterpret_cast<std::uintptr_t>(p) % 64 == 0);
+            res.deallocate(p, 64, 64);
+
+            auto q(res.allocate(24, 8));
+            auto q2(res.allocate(24, 8));
+            TEST_ASSERT(q != q2);
+            res.deallocate(q, 24, 8);
+            auto q3(res.allocate(20, 4));
+            TEST_ASSERT(q3 == q);
+            res.deallocate(q3, 20, 4);
+            res.deallocate(q2, 24, 8);
+        }
+
+        TEST_ASSERT_OP(upstream.count, ==, 0);
+        TEST_ASSERT_OP(res.shrinkToFit(), >, 0);
+        TEST_ASSERT_OP(res.shrinkToFit(), ==, 0);
+    }
+
+    {
+        struct TDBItem
+        {
+            int id, value;
+            inline TDBItem(int mId, int mValue) : id{mId}, value{mValue} {}
+        };
+
+        ssvu::DoubleBufferManager<TDBItem> db;
+        for(auto i(0); i < 100; ++i) db.create(i, i);
+
+        // Nothing is visible before the first publish
+        TEST_ASSERT_OP(db.acquire().size(), ==, 0);
+        db.publish();
+
+        {
+            auto snap(db.acquire());
+            TEST_ASSERT_OP(snap.size(), ==, 100);
+
+            // Writer mutations do not affect a held snapshot
+            db.forEach([&db](auto& mX)
+                {
+                    if(mX.id % 2 == 0)
+                        db.del(mX);
+                    else
+                        db.modify(mX).value = -mX.id;
+                });
+            db.create(1000, 1000);
+            db.refresh();
+            TEST_ASSERT_OP(db.size(), ==, 51);
+
+            auto sum(0);
+            for(const auto& x : snap) sum += x.value;
+            TEST_ASSERT_OP(sum, ==, 99 * 100 / 2);
+        }
+
+        // Both buffers receive the changes
+        for(auto r(0); r < 2; ++r)
+        {
+            db.publish();
+            auto snap(db.acquire());
+            TEST_ASSERT_OP(snap.size(), ==, 51);
+
+            auto sum(0);
+            for(const auto& x : snap)
+            {
+                TEST_ASSERT(x.id == 1000 || x.id % 2 == 1);
+                sum += x.value;
+            }
+            TEST_ASSERT_OP(sum, ==, 1000 - 50 * 50);
+        }
+
+        // Unmarked modifications are not published
+        db.forEach([](auto& mX) { mX.value = 0; });
+        db.publish();
+        TEST_ASSERT_OP(db.acquire()[0].value, !=, 0);
+
+        db.clear();
+        db.publish();
+        TEST_ASSERT_OP(db.acquire().size(), ==, 0);
+    }
+
+    {
+        struct TDBItem
+        {
+            int a, b;
+        };
+
+        // Readers iterate snapshots while the writer publishes
+        ssvu::DoubleBufferManager<TDBItem> db;
+        std::atomic<bool> done{false};
+        std::atomic<int> errors{0}, reads{0};
+
+        std::vector<std::thread> readers;
+        for(auto t(0); t < 3; ++t)
+            readers.emplace_back([&]
+                {
+                    while(!done.load())
+                    {
+                        auto snap(db.acquire());
+                        for(const auto& x : snap)
+                            if(x.a != x.b) ++errors;
+                        ++reads;
+                    }
+                });
+
+        for(auto f(0); f < 500 || reads.load() == 0; ++f)
+        {
+            db.create(TDBItem{f, f});
+            db.forEach([&db, f](auto& mX)
+                {
+                    if(mX.a % 7 == f % 7)
+                        db.del(mX);
+                    else if(mX.a % 3 == 0)
+                    {
+                        auto& y(db.modify(mX));
+                        ++y.a;
+                        ++y.b;
+                    }
+                });
+            db.publish();
+        }
+
+        done.store(true);
+        for(auto& t : readers) t.join();
+        TEST_ASSERT_OP(errors.load(), ==, 0);
+        TEST_ASSERT_OP(reads.load(), >, 0);
+    }
+
+    {
+        struct TEpItem
+        {
+            int& dc;
+            int magic{1234};
+            inline TEpItem(int& mDC) : dc(mDC) {}
+            inline ~TEpItem()
+            {
+                magic = 0;
+                ++dc;
+            }
+        };
+
+        int dc{0};
+        ssvu::MMEpochDomain domain;
+        ssvu::MonoManager<TEpItem> mm;
+        mm.setEpochDomain(&domain);
+
+        for(auto i(0); i < 10; ++i) mm.create(dc);
+        mm.refresh();
+
+        {
+            auto guard(domain.pin());
+            auto& x(*mm.begin()->get());
+            mm.del(x);
+            mm.refresh();
+
+            // Destruction is deferred while the epoch is pinned
+            TEST_ASSERT_OP(dc, ==, 0);
+            TEST_ASSERT_OP(mm.size(), ==, 9);
+            TEST_ASSERT_OP(mm.getRetiredCount(), ==, 1);
+            TEST_ASSERT(mm.isDead(&x));
+            TEST_ASSERT_OP(x.magic, ==, 1234);
+            TEST_ASSERT_OP(mm.reclaimRetired(), ==, 1);
+        }
+
+        TEST_ASSERT_OP(mm.reclaimRetired(), ==, 0);
+        TEST_ASSERT_OP(dc, ==, 1);
+
+        // Without pinned readers objects are destroyed by the refresh
+        mm.del(*mm.begin()->get());
+        mm.refresh();
+        TEST_ASSERT_OP(dc, ==, 2);
+        TEST_ASSERT_OP(mm.getRetiredCount(), ==, 0);
+
+        // Objects pinned after their removal do not delay it
+        mm.del(*mm.begin()->get());
+        mm.refresh();
+        {
+            auto guard(domain.pin());
+            mm.refresh();
+            TEST_ASSERT_OP(dc, ==, 3);
+        }
+
+        {
+            auto guard(domain.pin());
+            mm.clear();
+            TEST_ASSERT_OP(dc, ==, 3);
+            TEST_ASSERT_OP(mm.getRetiredCount(), ==, 7);
+        }
+
+        mm.setEpochDomain(nullptr);
+        TEST_ASSERT_OP(dc, ==, 10);
+    }
+
+    {
+        struct TEpItem
+        {
+            long int magic{1234};
+            inline ~TEpItem() { magic = 0; }
+        };
+
+        // Readers on other threads dereference objects that the writer
+        // deletes and refreshes concurrently
+        ssvu::MMEpochDomain domain{8};
+        ssvu::MonoManager<TEpItem> mm;
+        mm.setEpochDomain(&domain);
+
+        std::atomic<TEpItem*> current{&mm.create()};
+        std::atomic<bool> done{false};
+        std::atomic<int> errors{0}, deadSeen{0};
+
+        std::vector<std::thread> readers;
+        for(auto t(0); t < 3; ++t)
+            readers.emplace_back([&]
+                {
+                    while(!done.load())
+                    {
+                        auto guard(domain.pin());
+                        auto p(current.load(std::memory_order_acquire));
+                        if(p->magic != 1234) ++errors;
+
+                        // The writer may be deleting the object
+                        if(mm.isDead(p)) ++deadSeen;
+                    }
+                });
+
+        for(auto i(0); i < 2000; ++i)
+        {
+            auto& x(mm.create());
+            auto old(current.exchange(&x, std::memory_order_acq_rel));
+            mm.del(*old);
+            mm.refresh();
+        }
+
+        done.store(true);
+        for(auto& t : readers) t.join();
+        TEST_ASSERT_OP(errors.load(), ==, 0);
+        TEST_ASSERT_OP(mm.size(), ==, 1);
+    }
+
+    {
+        struct TDfItem
+        {
+            long int id;
+            int data[6];
+        };
+
+        ssvu::MonoManager<TDfItem> mm;
+        for(auto i(0); i < 3000; ++i) mm.create(TDfItem{i, {}});
+        mm.refresh();
+
+        // Nothing to defragment yet
+        TEST_ASSERT_OP(mm.defragment(1024), ==, 0);
+        TEST_ASSERT(!mm.isDefragmenting());
+
+        // Churn scatters the objects over the slabs
+        mm.delAll([](const auto& mX) { return mX.id % 3 != 0; });
+        mm.refresh();
+        for(auto i(0); i < 300; ++i) mm.create(TDfItem{3000 + i, {}});
+        mm.refresh();
+
+        long int idSum{0};
+        for(auto& p : mm) idSum += p->id;
+
+        auto count(mm.size());
+        std::size_t relocated{0};
+        auto onRelocate([&relocated](const TDfItem* mOld, TDfItem& mNew)
+            {
+                TEST_ASSERT(mOld != &mNew);
+                ++relocated;
+            });
+
+        auto copied(mm.defragment(256, onRelocate));
+        TEST_ASSERT(mm.isDefragmenting());
+        TEST_ASSERT_OP(copied, >=, 256);
+        TEST_ASSERT_OP(copied, <, 256 + 64);
+
+        while(mm.isDefragmenting()) mm.defragment(4096, onRelocate);
+        TEST_ASSERT_OP(relocated, ==, count);
+
+        // Objects are contiguous, in manager order
+        std::size_t breaks{0};
+        for(auto i(1u); i < mm.size(); ++i)
+        {
+            auto d(reinterpret_cast<const char*>(mm.getDataAt(i).get()) -
+                   reinterpret_cast<const char*>(mm.getDataAt(i - 1).get()));
+            if(d != std::ptrdiff_t(sizeof(TDfItem) + sizeof(void*))) ++breaks;
+        }
+        TEST_ASSERT_OP(breaks, <, 4);
+
+        long int idSumNew{0};
+        for(auto& p : mm)
+        {
+            idSumNew += p->id;
+            TEST_ASSERT(mm.isAlive(p.get()));
+        }
+        TEST_ASSERT_OP(idSumNew, ==, idSum);
+
+        // Deleting and creating still works on the moved objects
+        mm.delAll([](const auto& mX) { return mX.id % 2 == 0; });
+        mm.refresh();
+        mm.create(TDfItem{-1, {}});
+        mm.refresh();
+        TEST_ASSERT_OP(mm.size(), ==, count - count / 2 + 1);
+    }
+
+    {
+        struct TDfBase
+        {
+            long int id;
+        };
+        struct TDfBig : TDfBase
+        {
+            char data[100];
+        };
+
+        ssvu::PolyManager<TDfBase> mm;
+        for(auto i(0); i < 1000; ++i)
+        {
+            if(i % 2 == 0)
+                mm.create(TDfBase{i});
+            else
+                mm.create<TDfBig>(TDfBig{{i}, {}});
+        }
+        mm.refresh();
+        mm.delAll([](const auto& mX) { return mX.id % 4 < 2; });
+        mm.refresh();
+
+        while(mm.defragment(1024) != 0)
+        {
+        }
+
+        TEST_ASSERT(!mm.isDefragmenting());
+        TEST_ASSERT_OP(mm.size(), ==, 500);
+        for(auto& p : mm) TEST_ASSERT_OP(p->id % 4, >=, 2);
+    }
+
+    {
+        struct TVMItem
+        {
+            long int id;
+        };
+
+        // Pointer storage does not move while the manager grows
+        ssvu::VMMonoManager<TVMItem> mm;
+        mm.create(TVMItem{0});
+        auto data(&mm.getDataAt(0));
+
+        for(auto i(1); i < 100000; ++i) mm.create(TVMItem{i});
+#if defined(SSVU_GROWABLEARRAY_VM)
+        TEST_ASSERT(&mm.getDataAt(0) == data);
+#endif
+        mm.refresh();
+
+        mm.delAll([](const auto& mX) { return mX.id % 2 == 0; });
+        mm.refresh();
+        TEST_ASSERT_OP(mm.size(), ==, 50000);
+        TEST_ASSERT_OP(mm.shrinkToFit(), >, 0);
+#if defined(SSVU_GROWABLEARRAY_VM)
+        TEST_ASSERT(&mm.getDataAt(0) == data);
+#endif
+
+        mm.refreshParallel();
+        for(auto& p : mm) TEST_ASSERT_OP(p->id % 2, ==, 1);
+
+        ssvu::VMPolyManager<TVMItem> pm;
+        for(auto i(0); i < 1000; ++i) pm.create(TVMItem{i});
+        pm.refresh();
+        TEST_ASSERT_OP(pm.size(), ==, 1000);
+    }
+}
@@ -0,0 +1,346 @@
+// Copyright (c) 2013-2015 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: http://opensource.org/licenses/AFL-3.0
+
+// Allocation statistics are opt-in: they are tested in their own
+// translation unit, so that `MemoryManager.cpp` covers the default build
+#define SSVU_MEMORYMANAGER_STATS
+
+#include "SSVUtils/Core/Core.hpp"
+
+#include "SSVUtils/MemoryManager/MemoryManager.hpp"
+#include "SSVUtils/MemoryManager/StatsJson.hpp"
+
+#include "./utils/test_utils.hpp"
+
+#include <list>
+#include <memory_resource>
+#include <vector>
+
+int main()
+{
+    {
+        struct TMMStatItem
+        {
+            long int id;
+            inline TMMStatItem(long int mId) : id{mId}
+            {
+            }
+            inline virtual ~TMMStatItem()
+            {
+            }
+        };
+        struct TMMStatItemB : public TMMStatItem
+        {
+            char stuff[100];
+            using TMMStatItem::TMMStatItem;
+        };
+
+        {
+            ssvu::MonoManager<TMMStatItem> mm;
+            std::vector<TMMStatItem*> ptrs;
+
+            for(auto i(0); i < 100; ++i) ptrs.emplace_back(&mm.create(i));
+            mm.refresh();
+
+            auto s0(mm.getStats());
+            TEST_ASSERT_OP(s0.size, ==, 100);
+            TEST_ASSERT_OP(s0.pending, ==, 0);
+            TEST_ASSERT_OP(s0.chunks.size(), ==, 1);
+            TEST_ASSERT_OP(s0.total.live, ==, 100);
+            TEST_ASSERT_OP(s0.total.free, ==, 0);
+            TEST_ASSERT_OP(s0.total.created, ==, 100);
+            TEST_ASSERT_OP(s0.total.reused, ==, 0);
+            TEST_ASSERT_OP(s0.total.slabCount, >, 0);
+            TEST_ASSERT_OP(s0.total.bytesReserved, >=,
+                100 * s0.total.slotSize);
+
+            for(auto i(0); i < 40; ++i) mm.del(*ptrs[i]);
+            mm.refresh();
+
+            auto s1(mm.getStats());
+            TEST_ASSERT_OP(s1.total.live, ==, 60);
+            TEST_ASSERT_OP(s1.total.free, ==, 40);
+            TEST_ASSERT_OP(s1.total.recycled, ==, 40);
+
+            // Recycled memory is reused: no new slabs are allocated
+            for(auto i(0); i < 50; ++i) mm.create(i);
+
+            auto s2(mm.getStats());
+            TEST_ASSERT_OP(s2.pending, ==, 50);
+            TEST_ASSERT_OP(s2.total.live, ==, 110);
+            TEST_ASSERT_OP(s2.total.peakLive, ==, 110);
+            TEST_ASSERT_OP(s2.total.free, ==, 0);
+            TEST_ASSERT_OP(s2.total.reused, ==, 40);
+
+            auto delta(s2.total.getSince(s1.total));
+            TEST_ASSERT_OP(delta.created, ==, 50);
+            TEST_ASSERT_OP(delta.reused, ==, 40);
+            TEST_ASSERT_OP(delta.recycled, ==, 0);
+        }
+
+        {
+            ssvu::PolyManager<TMMStatItem> pm;
+            for(auto i(0); i < 10; ++i)
+            {
+                pm.create(i);
+                pm.template create<TMMStatItemB>(i);
+            }
+
+            // One chunk per size class
+            auto s(pm.getStats());
+            TEST_ASSERT_OP(s.chunks.size(), ==, 2);
+            TEST_ASSERT_OP(s.total.live, ==, 20);
+            TEST_ASSERT_OP(s.chunks[0].live, ==, 10);
+            TEST_ASSERT_OP(s.chunks[1].live, ==, 10);
+            TEST_ASSERT_OP(s.chunks[0].slotSize, <, s.chunks[1].slotSize);
+
+            auto str(ssvj::Val{s}.getWriteToStr());
+            auto v(ssvj::fromStr(str));
+            TEST_ASSERT_OP(v["total"]["live"].as<int>(), ==, 20);
+            TEST_ASSERT_OP(v["chunks"].as<ssvj::Val::Arr>().size(), ==, 2);
+            TEST_ASSERT_OP(v["pending"].as<int>(), ==, 20);
+        }
+
+        {
+            ssvu::PolyFixedRecycler<TMMStatItem, TMMStatItem, TMMStatItemB> pr;
+            auto p(pr.template create<TMMStatItemB>(0));
+            TEST_ASSERT_OP(pr.getStats().total.live, ==, 1);
+            p.reset();
+            TEST_ASSERT_OP(pr.getStats().total.free, ==, 1);
+        }
+    }
+    {
+        struct TMMTrimItem
+        {
+            long int id;
+            char data[24];
+            inline TMMTrimItem(long int mId) : id{mId} {}
+        };
+
+        {
+            ssvu::MonoRecycler<TMMTrimItem> mr;
+            std::vector<ssvu::MonoRecycler<TMMTrimItem>::PtrType> ptrs;
+            for(auto i(0); i < 20000; ++i) ptrs.emplace_back(mr.create(i));
+
+            auto s0(mr.getStats());
+            TEST_ASSERT_OP(s0.total.slabCount, >, 2);
+
+            for(auto i(0u); i < ptrs.size(); ++i)
+                if(i % 50 != 0) ptrs[i].reset();
+
+            TEST_ASSERT_OP(mr.shrinkToFit(), ==, 0);
+            TEST_ASSERT_OP(mr.getStats().total.free, ==, 20000 - 400);
+
+            for(auto i(0u); i < ptrs.size(); ++i)
+                if(i > 100) ptrs[i].reset();
+
+            TEST_ASSERT_OP(mr.trim(0), >, 0);
+
+            auto s1(mr.getStats());
+            TEST_ASSERT_OP(s1.total.slabCount, ==, 1);
+            TEST_ASSERT_OP(s1.total.free + 3, <=,
+                ssvu::Impl::SlabPolicy::initialBytes / sizeof(TMMTrimItem));
+            TEST_ASSERT_OP(s1.total.bytesReserved, <, s0.total.bytesReserved);
+
+            ptrs.clear();
+            TEST_ASSERT_OP(mr.shrinkToFit(), >, 0);
+            TEST_ASSERT_OP(mr.getStats().total.slabCount, ==, 0);
+            TEST_ASSERT_OP(mr.getStats().total.free, ==, 0);
+
+            auto p(mr.create(5));
+            TEST_ASSERT_OP(mr.getStats().total.slabCount, ==, 1);
+        }
+
+        {
+            ssvu::PolyManager<TMMTrimItem> mm;
+            for(auto i(0); i < 100000; ++i) mm.create(i);
+            mm.refresh();
+            for(auto& x : mm) mm.del(*x);
+            mm.refresh();
+
+            auto s0(mm.getStats());
+            TEST_ASSERT_OP(s0.total.free, ==, 100000);
+
+            TEST_ASSERT_OP(mm.shrinkToFit(), >, s0.total.bytesReserved);
+            auto s1(mm.getStats());
+            TEST_ASSERT_OP(s1.total.bytesReserved, ==, 0);
+            TEST_ASSERT_OP(s1.capacity, <, s0.capacity);
+            TEST_ASSERT_OP(s1.bytesIndex, <, s0.bytesIndex);
+        }
+
+        {
+            // Automatic trimming bounds the memory kept after a spike
+            ssvu::BitsetMonoManager<TMMTrimItem> mm;
+            mm.setAutoTrim(1000);
+
+            for(auto r(0); r < 3; ++r)
+            {
+                for(auto i(0); i < 50000; ++i) mm.create(i);
+                mm.refresh();
+
+                auto sPeak(mm.getStats());
+                for(auto& x : mm) mm.del(*x);
+                mm.refresh();
+
+                auto s(mm.getStats());
+                TEST_ASSERT_OP(s.total.live, ==, 0);
+                TEST_ASSERT_OP(s.total.free, <=, 1000);
+                TEST_ASSERT_OP(
+                    s.total.bytesReserved, <, sPeak.total.bytesReserved / 10);
+            }
+        }
+    }
+    {
+        struct TMMBulkItem
+        {
+            long int id, value;
+            inline TMMBulkItem(long int mId, long int mValue)
+                : id{mId}, value{mValue}
+            {
+            }
+            inline virtual ~TMMBulkItem()
+            {
+            }
+        };
+        struct TMMBulkItemB : public TMMBulkItem
+        {
+            char data[40];
+            using TMMBulkItem::TMMBulkItem;
+        };
+
+        auto runTest([](auto& mM)
+            {
+                mM.template createRange<TMMBulkItemB>(5000,
+                    [](auto& mX, std::size_t mI) { mX.id = mI; }, -1, 7);
+                mM.refresh();
+                mM.delAll([](const auto& mX) { return mX.id % 2 == 0; });
+                mM.refresh();
+
+                // Recycled memory is used first
+                auto s0(mM.getStats());
+                mM.template createN<TMMBulkItemB>(2510, 0, 0);
+                auto s1(mM.getStats());
+                TEST_ASSERT_OP(s1.total.reused - s0.total.reused, ==, 2500);
+                TEST_ASSERT_OP(s1.total.slabCount - s0.total.slabCount, <=, 1);
+
+                // A burst is carved out of a single slab
+                mM.createN(100000, 0, 0);
+                auto s2(mM.getStats());
+                TEST_ASSERT_OP(s2.total.slabCount - s1.total.slabCount, ==, 1);
+            });
+
+        {
+            ssvu::PolyManager<TMMBulkItem> pm;
+            runTest(pm);
+        }
+        {
+            ssvu::BitsetPolyManager<TMMBulkItem> pm;
+            runTest(pm);
+        }
+    }
+    {
+        struct TMMThrowItem
+        {
+            long int id, pad;
+            inline TMMThrowItem(long int mId) : id{mId}, pad{0}
+            {
+                if(mId < 0) throw mId;
+            }
+        };
+
+        // Memory carved out of a slab for a throwing constructor is
+        // recycled
+        ssvu::MonoRecycler<TMMThrowItem> mr;
+        auto threw(false);
+        try
+        {
+            mr.createN(3, [](auto&&) {}, -1);
+        }
+        catch(long int)
+        {
+            threw = true;
+        }
+
+        auto s(mr.getStats());
+        TEST_ASSERT(threw);
+        TEST_ASSERT_OP(s.total.live, ==, 0);
+        TEST_ASSERT_OP(s.total.free, ==, 1);
+    }
+    {
+        ssvu::MMPoolResource res;
+
+        {
+            std::pmr::list<int> l{&res};
+            for(auto i(0); i < 1000; ++i) l.emplace_back(i);
+            TEST_ASSERT_OP(res.getStats().total.live, ==, 1000);
+
+            // Deallocated nodes are reused
+            for(auto r(0); r < 10; ++r)
+            {
+                l.clear();
+                for(auto i(0); i < 1000; ++i) l.emplace_back(i);
+            }
+
+            auto s(res.getStats());
+            TEST_ASSERT_OP(s.total.live, ==, 1000);
+            TEST_ASSERT_OP(s.total.reused, ==, 10 * 1000);
+        }
+
+        TEST_ASSERT_OP(res.getStats().total.live, ==, 0);
+        TEST_ASSERT_OP(res.shrinkToFit(), >, 0);
+        TEST_ASSERT_OP(res.getStats().total.bytesReserved, ==, 0);
+    }
+    {
+        struct TEpItem
+        {
+            long int id, pad;
+        };
+
+        ssvu::MMEpochDomain domain;
+        ssvu::MonoManager<TEpItem> mm;
+        mm.setEpochDomain(&domain);
+
+        for(auto i(0); i < 10; ++i) mm.create(TEpItem{i, 0});
+        mm.refresh();
+
+        {
+            auto guard(domain.pin());
+            mm.del(*mm.begin()->get());
+            mm.refresh();
+
+            // Retired objects are reported until they are destroyed
+            TEST_ASSERT_OP(mm.getStats().retired, ==, 1);
+            TEST_ASSERT_OP(mm.getStats().size, ==, 9);
+        }
+
+        mm.reclaimRetired();
+        TEST_ASSERT_OP(mm.getStats().retired, ==, 0);
+    }
+    {
+        struct TDfItem
+        {
+            long int id;
+            int data[6];
+        };
+
+        ssvu::MonoManager<TDfItem> mm;
+        for(auto i(0); i < 3000; ++i) mm.create(TDfItem{i, {}});
+        mm.refresh();
+
+        mm.delAll([](const auto& mX) { return mX.id % 3 != 0; });
+        mm.refresh();
+        for(auto i(0); i < 300; ++i) mm.create(TDfItem{3000 + i, {}});
+        mm.refresh();
+
+        // Defragmentation releases the slabs emptied by the churn
+        auto s0(mm.getStats());
+        mm.defragment(4096);
+        while(mm.isDefragmenting()) mm.defragment(4096);
+
+        auto s1(mm.getStats());
+        TEST_ASSERT_OP(s1.total.live, ==, s0.total.live);
+        TEST_ASSERT_OP(s1.total.bytesReserved, <, s0.total.bytesReserved);
+        TEST_ASSERT_OP(s1.total.free, <, s0.total.free);
+    }
+}